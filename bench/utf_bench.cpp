@@ -0,0 +1,327 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <utf/codepage.hpp>
+#include <utf/convert.hpp>
+#include <utf/graphemes.hpp>
+#include <utf/line_index.hpp>
+#include <utf/normalize.hpp>
+#include <utf/utf.hpp>
+#include <vector>
+
+namespace {
+	enum class script { ascii, latin, cyrillic, cjk, emoji, mixed, regions };
+
+	constexpr std::size_t text_size = 1024 * 1024;
+
+	/*
+	 * Deterministic text of roughly text_size bytes; in the "mixed" script
+	 * each word is taken from a different, randomly chosen script, which is
+	 * the worst case for branch prediction. The "regions" script changes
+	 * every few hundred words, like documents quoting other languages do.
+	 */
+	std::string make_text(script kind) {
+		static constexpr std::u32string_view words[] = {
+		    U"lorem ", U"zażółć ", U"съешь ", U"漢字仮名 ", U"😀🚀 ",
+		};
+
+		std::mt19937 random{5489u};
+		std::u32string text;
+		std::string utf8;
+		auto index = static_cast<std::size_t>(kind);
+		for (std::size_t count = 0; utf8.size() < text_size; ++count) {
+			if (kind == script::mixed ||
+			    (kind == script::regions && count % 256 == 0))
+				index = random() % std::size(words);
+			text += words[index];
+			if (text.size() > 4096) {
+				utf8 += utf::as_str8(text);
+				text.clear();
+			}
+		}
+		return utf8;
+	}
+
+	template <script Kind>
+	void is_valid_utf8(benchmark::State& state) {
+		auto const text = make_text(Kind);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::is_valid(text));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	template <script Kind>
+	void utf8_to_utf16(benchmark::State& state) {
+		auto const text = make_text(Kind);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::as_u16(text));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	template <script Kind>
+	void utf8_to_utf32(benchmark::State& state) {
+		auto const text = make_text(Kind);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::as_u32(text));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	// into a reused vector, without a temporary string
+	template <script Kind>
+	void utf8_to_utf16_vector(benchmark::State& state) {
+		auto const text = make_text(Kind);
+		std::vector<char16_t> out;
+		for (auto _ : state) {
+			out.clear();
+			benchmark::DoNotOptimize(
+			    utf::convert<char, char16_t>(text, out).status);
+		}
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	template <script Kind>
+	void count_graphemes_utf8(benchmark::State& state) {
+		auto const text = make_text(Kind);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::count_graphemes(text));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	template <script Kind>
+	void is_nfc_quick_utf8(benchmark::State& state) {
+		auto const text = make_text(Kind);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::is_nfc_quick(text));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	// the same text in NFD, composed back
+	template <script Kind>
+	void to_nfc_utf8(benchmark::State& state) {
+		auto const text = utf::to_nfd(make_text(Kind));
+		std::string buffer;
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::to_nfc(text, buffer));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	template <script Kind>
+	void is_valid_utf16(benchmark::State& state) {
+		auto const text = utf::as_u16(make_text(Kind));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::is_valid(text));
+		state.SetBytesProcessed(
+		    state.iterations() *
+		    static_cast<std::int64_t>(text.size() * sizeof(char16_t)));
+	}
+
+	void is_valid_utf32(benchmark::State& state) {
+		auto const text = utf::as_u32(make_text(script::mixed));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::is_valid(text));
+		state.SetBytesProcessed(
+		    state.iterations() *
+		    static_cast<std::int64_t>(text.size() * sizeof(char32_t)));
+	}
+
+	void sanitize_utf32(benchmark::State& state) {
+		auto const text = utf::as_u32(make_text(script::mixed));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::sanitize(text));
+		state.SetBytesProcessed(
+		    state.iterations() *
+		    static_cast<std::int64_t>(text.size() * sizeof(char32_t)));
+	}
+
+	void iso8859_2_to_utf16(benchmark::State& state) {
+		auto const text = utf::as_codepage(make_text(script::latin),
+		                                   utf::codepage::iso8859_2);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(
+			    utf::as_u16(text, utf::codepage::iso8859_2));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	void utf16_to_iso8859_2(benchmark::State& state) {
+		auto const text = utf::as_u16(make_text(script::latin));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(
+			    utf::as_codepage(text, utf::codepage::iso8859_2));
+		state.SetBytesProcessed(
+		    state.iterations() *
+		    static_cast<std::int64_t>(text.size() * sizeof(char16_t)));
+	}
+
+	// every other unit a NUL, each one ending an ASCII run
+	void utf16_to_mutf8_nul_dense(benchmark::State& state) {
+		std::u16string text;
+		while (text.size() < text_size / sizeof(char16_t)) {
+			text.push_back(u'a');
+			text.push_back(u'\0');
+		}
+		for (auto _ : state)
+			benchmark::DoNotOptimize(
+			    utf::as_str8(text, utf::utf8_variant::mutf8));
+		state.SetBytesProcessed(
+		    state.iterations() *
+		    static_cast<std::int64_t>(text.size() * sizeof(char16_t)));
+	}
+
+	void line_index_utf8(benchmark::State& state) {
+		auto const text = make_text(script::regions);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::line_index{text});
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	/*
+	 * The index of a text larger than most last-level caches, with a line
+	 * every ten words, where the build goes out to memory.
+	 */
+	void line_index_utf8_large(benchmark::State& state) {
+		static auto const text = [] {
+			auto block = make_text(script::mixed);
+			std::size_t words = 0;
+			for (auto& c : block) {
+				if (c == ' ' && ++words % 10 == 0) c = '\n';
+			}
+			std::string result;
+			for (int copy = 0; copy < 64; ++copy)
+				result += block;
+			return result;
+		}();
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::line_index{text});
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+
+	std::u16string const& large_utf16() {
+		static auto const text = [] {
+			std::u16string result;
+			auto const block = utf::as_u16(make_text(script::mixed));
+			for (int copy = 0; copy < 128; ++copy)
+				result += block;
+			return result;
+		}();
+		return text;
+	}
+
+	// transcode() into a buffer of the caller, with room for the output
+	utf::transcode_result to_utf8(std::u16string_view text, std::string& out) {
+		return utf::transcode<char, char16_t>(text, out.data(), out.size());
+	}
+
+	/*
+	 * Converts a buffer larger than most last-level caches, with the
+	 * streaming stores on (1) or off (0).
+	 */
+	void utf16_to_utf8_large(benchmark::State& state) {
+		auto const& text = large_utf16();
+		std::string out(text.size() * 3, '\0');
+		auto const previous = utf::streaming_threshold();
+		utf::set_streaming_threshold(state.range(0) ? 0 : utf::npos);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(to_utf8(text, out).written);
+		utf::set_streaming_threshold(previous);
+		state.SetBytesProcessed(
+		    state.iterations() *
+		    static_cast<std::int64_t>(text.size() * sizeof(char16_t)));
+	}
+
+	/*
+	 * The cost of a large conversion to another thread: the neighbour
+	 * keeps reading its working set, which fits in the cache, and reports
+	 * how many times it got through it in a second of the conversion.
+	 */
+	void utf16_to_utf8_neighbour(benchmark::State& state) {
+		auto const& text = large_utf16();
+		auto const previous = utf::streaming_threshold();
+		utf::set_streaming_threshold(state.range(0) ? 0 : utf::npos);
+
+		std::string out(text.size() * 3, '\0');
+		std::vector<std::uint64_t> working_set(4 * 1024 * 1024 / 8, 1);
+		std::atomic<bool> done{false};
+		std::atomic<std::uint64_t> passes{0};
+		std::thread neighbour{[&] {
+			std::uint64_t sum = 0;
+			while (!done.load(std::memory_order_relaxed)) {
+				for (auto const value : working_set)
+					sum += value;
+				passes.fetch_add(1, std::memory_order_relaxed);
+			}
+			benchmark::DoNotOptimize(sum);
+		}};
+
+		auto const start = std::chrono::steady_clock::now();
+		for (auto _ : state)
+			benchmark::DoNotOptimize(to_utf8(text, out).written);
+		std::chrono::duration<double> const elapsed =
+		    std::chrono::steady_clock::now() - start;
+		done = true;
+		neighbour.join();
+
+		utf::set_streaming_threshold(previous);
+		state.counters["neighbour_passes_per_s"] =
+		    static_cast<double>(passes.load()) / elapsed.count();
+		state.SetBytesProcessed(
+		    state.iterations() *
+		    static_cast<std::int64_t>(text.size() * sizeof(char16_t)));
+	}
+
+	void invalid_offset_large(benchmark::State& state) {
+		std::string text;
+		auto const block = make_text(script::mixed);
+		for (int copy = 0; copy < 64; ++copy)
+			text += block;
+		auto const threads = static_cast<unsigned>(state.range(0));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(utf::invalid_offset(text, threads));
+		state.SetBytesProcessed(state.iterations() *
+		                        static_cast<std::int64_t>(text.size()));
+	}
+}  // namespace
+
+BENCHMARK(is_valid_utf32);
+BENCHMARK(sanitize_utf32);
+BENCHMARK(iso8859_2_to_utf16);
+BENCHMARK(utf16_to_iso8859_2);
+BENCHMARK(utf16_to_mutf8_nul_dense);
+BENCHMARK(line_index_utf8);
+BENCHMARK(line_index_utf8_large);
+BENCHMARK(utf16_to_utf8_large)->Arg(0)->Arg(1);
+BENCHMARK(utf16_to_utf8_neighbour)->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(invalid_offset_large)->Arg(1)->Arg(4)->Arg(0)->UseRealTime();
+
+#define UTF_BENCHMARK_SCRIPTS(NAME)                 \
+	BENCHMARK_TEMPLATE(NAME, script::ascii);    \
+	BENCHMARK_TEMPLATE(NAME, script::latin);    \
+	BENCHMARK_TEMPLATE(NAME, script::cyrillic); \
+	BENCHMARK_TEMPLATE(NAME, script::cjk);      \
+	BENCHMARK_TEMPLATE(NAME, script::emoji);    \
+	BENCHMARK_TEMPLATE(NAME, script::mixed);    \
+	BENCHMARK_TEMPLATE(NAME, script::regions)
+
+UTF_BENCHMARK_SCRIPTS(is_valid_utf8);
+UTF_BENCHMARK_SCRIPTS(is_valid_utf16);
+UTF_BENCHMARK_SCRIPTS(utf8_to_utf16);
+UTF_BENCHMARK_SCRIPTS(utf8_to_utf32);
+UTF_BENCHMARK_SCRIPTS(utf8_to_utf16_vector);
+UTF_BENCHMARK_SCRIPTS(count_graphemes_utf8);
+UTF_BENCHMARK_SCRIPTS(is_nfc_quick_utf8);
+UTF_BENCHMARK_SCRIPTS(to_nfc_utf8);
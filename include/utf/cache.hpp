@@ -0,0 +1,48 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <memory>
+#include <string>
+#include <utf/utf.hpp>
+#include <vector>
+
+namespace utf {
+	/*
+	 * Bounded cache of UTF-16 conversions, for programs converting the same
+	 * small set of strings over and over. The results are shared and never
+	 * change, so they may outlive their place in the cache. Lookups take a
+	 * shared lock of one of the shards, so concurrent readers do not wait
+	 * for each other; when a shard is full, an entry not used since the
+	 * last sweep of the clock hand is dropped.
+	 */
+	class conversion_cache {
+	public:
+		static constexpr std::size_t default_capacity = 4096;
+		static constexpr std::size_t default_shards = 16;
+
+		explicit conversion_cache(std::size_t capacity = default_capacity,
+		                          std::size_t shards = default_shards);
+		~conversion_cache();
+
+		conversion_cache(conversion_cache const&) = delete;
+		conversion_cache& operator=(conversion_cache const&) = delete;
+
+		std::shared_ptr<const std::u16string> as_u16(std::string_view src);
+#ifdef __cpp_lib_char8_t
+		std::shared_ptr<const std::u16string> as_u16(std::u8string_view src) {
+			return as_u16(as_str8_view(src));
+		}
+#endif
+
+		std::size_t size() const;
+		std::size_t capacity() const noexcept { return capacity_; }
+		void clear();
+
+	private:
+		struct shard;
+
+		std::size_t capacity_;
+		std::vector<std::unique_ptr<shard>> shards_;
+	};
+}  // namespace utf
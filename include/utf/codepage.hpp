@@ -0,0 +1,41 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace utf {
+	/*
+	 * Single-byte code pages, ASCII in the lower half. Bytes left undefined
+	 * by a Windows code page stand for the C1 controls of the same value,
+	 * as they do in web browsers, so every byte decodes to something.
+	 */
+	enum class codepage {
+		iso8859_1,
+		iso8859_2,
+		iso8859_5,
+		iso8859_15,
+		windows1250,
+		windows1251,
+		windows1252,
+		koi8_r,
+	};
+
+	std::string as_str8(std::string_view src, codepage from);
+	std::u16string as_u16(std::string_view src, codepage from);
+	std::u32string as_u32(std::string_view src, codepage from);
+
+	/*
+	 * Return an empty string, if the source is ill-formed or has a
+	 * character missing from the code page.
+	 */
+	std::string as_codepage(std::string_view src, codepage to);
+	std::string as_codepage(std::u16string_view src, codepage to);
+	std::string as_codepage(std::u32string_view src, codepage to);
+
+#ifdef __cpp_lib_char8_t
+	std::u8string as_u8(std::string_view src, codepage from);
+	std::string as_codepage(std::u8string_view src, codepage to);
+#endif
+}  // namespace utf
@@ -0,0 +1,429 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utf/utf.hpp>
+#include <utility>
+
+namespace utf {
+	namespace errors {
+		enum class action { stop, replace, skip };
+
+		/*
+		 * Error policies are called with the offset and the length of each
+		 * ill-formed sequence and tell the engine, what to do with it. The
+		 * length is the maximal subpart of the sequence, the same part that
+		 * becomes a single U+FFFD on replacement.
+		 */
+		struct strict {
+			constexpr action operator()(std::size_t,
+			                            std::size_t) const noexcept {
+				return action::stop;
+			}
+		};
+
+		struct replace {
+			constexpr action operator()(std::size_t,
+			                            std::size_t) const noexcept {
+				return action::replace;
+			}
+		};
+
+		struct skip {
+			constexpr action operator()(std::size_t,
+			                            std::size_t) const noexcept {
+				return action::skip;
+			}
+		};
+
+		/*
+		 * Hands each ill-formed sequence to the handler and leaves it out of
+		 * the output.
+		 */
+		template <typename Handler>
+		struct report {
+			Handler handler;
+
+			constexpr action operator()(std::size_t offset,
+			                            std::size_t length) {
+				handler(offset, length);
+				return action::skip;
+			}
+		};
+
+		template <typename Handler>
+		report(Handler) -> report<Handler>;
+	}  // namespace errors
+
+	/*
+	 * Sink over a fixed buffer; a write, which does not fit, is refused as
+	 * a whole.
+	 */
+	template <typename Char>
+	class span_sink {
+	public:
+		constexpr span_sink(Char* data, std::size_t size) noexcept
+		    : data_{data}, size_{size} {}
+		template <std::size_t Size>
+		constexpr span_sink(Char (&data)[Size]) noexcept
+		    : data_{data}, size_{Size} {}
+		template <std::size_t Size>
+		constexpr span_sink(std::array<Char, Size>& data) noexcept
+		    : data_{data.data()}, size_{Size} {}
+
+		constexpr bool write(Char const* units, std::size_t count) noexcept {
+			if (size_ - used_ < count) return false;
+			for (std::size_t index = 0; index < count; ++index)
+				data_[used_++] = units[index];
+			return true;
+		}
+
+		constexpr Char* data() const noexcept { return data_; }
+		constexpr std::size_t size() const noexcept { return used_; }
+		constexpr std::basic_string_view<Char> view() const noexcept {
+			return {data_, used_};
+		}
+
+	private:
+		Char* data_;
+		std::size_t size_;
+		std::size_t used_{};
+	};
+
+	template <typename Char, std::size_t Size>
+	span_sink(Char (&)[Size]) -> span_sink<Char>;
+	template <typename Char, std::size_t Size>
+	span_sink(std::array<Char, Size>&) -> span_sink<Char>;
+
+	namespace detail {
+		template <typename Sink, typename Char, typename = void>
+		struct has_write : std::false_type {};
+		template <typename Sink, typename Char>
+		struct has_write<Sink,
+		                 Char,
+		                 std::void_t<decltype(std::declval<Sink&>().write(
+		                     std::declval<Char const*>(),
+		                     std::size_t{}))>> : std::true_type {};
+
+		template <typename Sink, typename Char, typename = void>
+		struct has_append : std::false_type {};
+		template <typename Sink, typename Char>
+		struct has_append<Sink,
+		                  Char,
+		                  std::void_t<decltype(std::declval<Sink&>().append(
+		                      std::declval<Char const*>(),
+		                      std::size_t{}))>> : std::true_type {};
+
+		template <typename Sink, typename Char, typename = void>
+		struct has_range_insert : std::false_type {};
+		template <typename Sink, typename Char>
+		struct has_range_insert<
+		    Sink,
+		    Char,
+		    std::void_t<decltype(std::declval<Sink&>().insert(
+		        std::declval<Sink&>().end(),
+		        std::declval<Char const*>(),
+		        std::declval<Char const*>()))>> : std::true_type {};
+
+		template <typename Sink, typename = void>
+		struct has_reserve : std::false_type {};
+		template <typename Sink>
+		struct has_reserve<Sink,
+		                   std::void_t<decltype(std::declval<Sink&>().reserve(
+		                       std::declval<Sink&>().size() +
+		                       std::size_t{}))>> : std::true_type {};
+
+		/*
+		 * A sink is anything with `bool write(Char const*, std::size_t)`,
+		 * which may refuse the units, or a container taking them with
+		 * append(), a range insert() or push_back().
+		 */
+		template <typename Char, typename Sink>
+		inline bool write_units(Sink& sink,
+		                        Char const* units,
+		                        std::size_t count) {
+			if constexpr (has_write<Sink, Char>::value) {
+				return sink.write(units, count);
+			} else if constexpr (has_append<Sink, Char>::value) {
+				sink.append(units, count);
+				return true;
+			} else if constexpr (has_range_insert<Sink, Char>::value) {
+				sink.insert(sink.end(), units, units + count);
+				return true;
+			} else {
+				for (std::size_t index = 0; index < count; ++index)
+					sink.push_back(units[index]);
+				return true;
+			}
+		}
+
+		enum class decode_status { ok, invalid, incomplete };
+
+		struct decoded {
+			char32_t ch{};
+			std::size_t length{};
+			decode_status status{decode_status::ok};
+		};
+
+		/*
+		 * Decodes the code point at the start of the buffer. On error, the
+		 * length is the one of the maximal subpart of the sequence, and the
+		 * sequence is incomplete, if only the end of the buffer cut it
+		 * short.
+		 */
+		template <typename Char>
+		inline decoded decode_utf8(Char const* data,
+		                           std::size_t length) noexcept {
+			auto const lead = static_cast<std::uint8_t>(data[0]);
+			if (lead < 0x80) return {lead, 1};
+
+			std::size_t trailing = 0;
+			char32_t ch = 0;
+			std::uint8_t low = 0x80;
+			std::uint8_t high = 0xBF;
+			if (lead < 0xC2) {
+				return {0, 1, decode_status::invalid};
+			} else if (lead < 0xE0) {
+				trailing = 1;
+				ch = lead & 0x1Fu;
+			} else if (lead < 0xF0) {
+				trailing = 2;
+				ch = lead & 0x0Fu;
+				if (lead == 0xE0) low = 0xA0;
+				if (lead == 0xED) high = 0x9F;
+			} else if (lead < 0xF5) {
+				trailing = 3;
+				ch = lead & 0x07u;
+				if (lead == 0xF0) low = 0x90;
+				if (lead == 0xF4) high = 0x8F;
+			} else {
+				return {0, 1, decode_status::invalid};
+			}
+
+			std::size_t used = 1;
+			for (; used <= trailing; ++used) {
+				if (used == length) return {0, used, decode_status::incomplete};
+				auto const byte = static_cast<std::uint8_t>(data[used]);
+				if (byte < low || byte > high)
+					return {0, used, decode_status::invalid};
+				low = 0x80;
+				high = 0xBF;
+				ch = (ch << 6) | (byte & 0x3Fu);
+			}
+			return {ch, used};
+		}
+
+		template <typename Char>
+		inline decoded decode_utf16(Char const* data,
+		                            std::size_t length) noexcept {
+			char32_t const lead = static_cast<char16_t>(data[0]);
+			if (lead < 0xD800 || lead > 0xDFFF) return {lead, 1};
+			if (lead > 0xDBFF) return {0, 1, decode_status::invalid};
+			if (length < 2) return {0, 1, decode_status::incomplete};
+			char32_t const trail = static_cast<char16_t>(data[1]);
+			if (trail < 0xDC00 || trail > 0xDFFF)
+				return {0, 1, decode_status::invalid};
+			return {((lead - 0xD800) << 10) + (trail - 0xDC00) + 0x10000, 2};
+		}
+
+		template <typename Char>
+		inline decoded decode_utf32(Char const* data) noexcept {
+			auto const ch = static_cast<char32_t>(data[0]);
+			if ((ch >= 0xD800 && ch <= 0xDFFF) || ch > 0x10FFFF)
+				return {0, 1, decode_status::invalid};
+			return {ch, 1};
+		}
+
+		template <typename Char>
+		inline decoded decode_next(Char const* data,
+		                           std::size_t length) noexcept {
+			if constexpr (sizeof(Char) == 1)
+				return decode_utf8(data, length);
+			else if constexpr (sizeof(Char) == 2)
+				return decode_utf16(data, length);
+			else
+				return decode_utf32(data);
+		}
+
+		/*
+		 * Writes a scalar value in the encoding of the unit and returns the
+		 * number of units written.
+		 */
+		template <typename Char>
+		inline std::size_t encode_scalar(char32_t ch, Char* target) noexcept {
+			if constexpr (sizeof(Char) == 1) {
+				if (ch < 0x80) {
+					target[0] = static_cast<Char>(ch);
+					return 1;
+				}
+				if (ch < 0x800) {
+					target[0] = static_cast<Char>(0xC0 | (ch >> 6));
+					target[1] = static_cast<Char>(0x80 | (ch & 0x3F));
+					return 2;
+				}
+				if (ch < 0x10000) {
+					target[0] = static_cast<Char>(0xE0 | (ch >> 12));
+					target[1] = static_cast<Char>(0x80 | ((ch >> 6) & 0x3F));
+					target[2] = static_cast<Char>(0x80 | (ch & 0x3F));
+					return 3;
+				}
+				target[0] = static_cast<Char>(0xF0 | (ch >> 18));
+				target[1] = static_cast<Char>(0x80 | ((ch >> 12) & 0x3F));
+				target[2] = static_cast<Char>(0x80 | ((ch >> 6) & 0x3F));
+				target[3] = static_cast<Char>(0x80 | (ch & 0x3F));
+				return 4;
+			} else if constexpr (sizeof(Char) == 2) {
+				if (ch < 0x10000) {
+					target[0] = static_cast<Char>(ch);
+					return 1;
+				}
+				ch -= 0x10000;
+				target[0] = static_cast<Char>(0xD800 + (ch >> 10));
+				target[1] = static_cast<Char>(0xDC00 + (ch & 0x3FF));
+				return 2;
+			} else {
+				target[0] = static_cast<Char>(ch);
+				return 1;
+			}
+		}
+
+		// length of the run of ASCII bytes, eight at a time
+		template <typename Char>
+		inline std::size_t ascii_run(Char const* data,
+		                             std::size_t length) noexcept {
+			std::size_t index = 0;
+			for (; index + 8 <= length; index += 8) {
+				std::uint64_t word;
+				std::memcpy(&word, data + index, sizeof(word));
+				if (word & 0x8080'8080'8080'8080u) break;
+			}
+			while (index < length &&
+			       static_cast<std::uint8_t>(data[index]) < 0x80)
+				++index;
+			return index;
+		}
+	}  // namespace detail
+
+	/*
+	 * Converts the text from the encoding of From units to the one of To
+	 * units (UTF-8 for one-byte units, UTF-16 for two-byte ones and UTF-32
+	 * for four-byte ones), writing it to the sink. The units are staged in
+	 * a small block and handed to the sink in bulk; if a write is refused,
+	 * the block is taken back and written one code point at a time, so
+	 * the conversion stops with output_full on a code point boundary.
+	 * With errors::strict, the status is `invalid` or `incomplete` and
+	 * `read` is the offset of the ill-formed sequence.
+	 */
+	template <typename From,
+	          typename To,
+	          typename ErrorPolicy = errors::strict,
+	          typename Sink>
+	inline transcode_result convert(std::basic_string_view<From> src,
+	                                Sink&& sink,
+	                                ErrorPolicy policy = {}) {
+		using sink_type = std::remove_reference_t<Sink>;
+		static constexpr std::size_t block_size = 64;
+
+		if constexpr (detail::has_reserve<sink_type>::value)
+			sink.reserve(sink.size() + src.size());
+
+		transcode_result result{};
+		auto const data = src.data();
+		auto const size = src.size();
+
+		To block[block_size];
+		std::size_t filled = 0;
+		std::size_t pos = 0;
+		std::size_t block_start = 0;  // where the units in the block came from
+		bool exact = false;           // one code point per write
+
+		// false, when the sink is full
+		auto const flush = [&] {
+			if (filled && !detail::write_units(sink, +block, filled)) {
+				filled = 0;
+				if (exact) return false;
+				pos = block_start;
+				exact = true;
+				return true;
+			}
+			result.written += filled;
+			filled = 0;
+			block_start = pos;
+			return true;
+		};
+
+		while (true) {
+			if (filled && (exact || block_size - filled < 4 || pos == size)) {
+				if (!flush()) {
+					result.status = transcode_status::output_full;
+					break;
+				}
+				continue;
+			}
+			if (pos == size) break;
+
+			if constexpr (sizeof(From) == 1) {
+				if (!exact) {
+					auto const run = detail::ascii_run(
+					    data + pos, std::min(size - pos, block_size - filled));
+					for (std::size_t index = 0; index < run; ++index)
+						block[filled + index] = static_cast<To>(data[pos + index]);
+					filled += run;
+					pos += run;
+					if (run) continue;
+				}
+			}
+
+			auto const next = detail::decode_next(data + pos, size - pos);
+			if (next.status == detail::decode_status::ok) {
+				if constexpr (sizeof(From) == sizeof(To)) {
+					for (std::size_t index = 0; index < next.length; ++index)
+						block[filled++] = static_cast<To>(data[pos + index]);
+				} else {
+					filled += detail::encode_scalar(next.ch, block + filled);
+				}
+				pos += next.length;
+				continue;
+			}
+
+			// the policy sees each error once, so nothing before it may
+			// be taken back afterwards
+			if (filled) {
+				if (!flush()) {
+					result.status = transcode_status::output_full;
+					break;
+				}
+				continue;
+			}
+
+			auto const action = policy(pos, next.length);
+			if (action == errors::action::stop) {
+				result.status = next.status == detail::decode_status::incomplete
+				                    ? transcode_status::incomplete
+				                    : transcode_status::invalid;
+				break;
+			}
+			if (action == errors::action::replace) {
+				To units[4];
+				auto const length = detail::encode_scalar(U'\uFFFD', units);
+				if (!detail::write_units(sink, +units, length)) {
+					result.status = transcode_status::output_full;
+					break;
+				}
+				result.written += length;
+			}
+			pos += next.length;
+			block_start = pos;
+		}
+
+		result.read = block_start;
+		return result;
+	}
+}  // namespace utf
@@ -0,0 +1,35 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <cstddef>
+#include <utf/utf.hpp>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+namespace utf {
+	struct detect_result {
+		encoding guess{encoding::utf8};
+		// from 0 (nothing fits) to 1 (BOM, or nothing else fits as well)
+		double confidence{};
+		// size of the byte order mark to skip, if there was one
+		std::size_t bom_size{};
+	};
+
+	/*
+	 * Guesses the encoding of a buffer, either from its BOM or from the
+	 * structure of the text: where the zero bytes are, which forms would
+	 * be well-formed. Everything is collected in a single pass over the
+	 * data; a sequence cut off at the end of the buffer is not an error,
+	 * so the beginning of a file is enough.
+	 */
+	detect_result detect(std::byte const* data, std::size_t size);
+
+#ifdef __cpp_lib_span
+	inline detect_result detect(std::span<const std::byte> data) {
+		return detect(data.data(), data.size());
+	}
+#endif
+}  // namespace utf
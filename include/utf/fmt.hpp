@@ -0,0 +1,26 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <fmt/format.h>
+#include <utf/format.hpp>
+
+template <typename Char>
+struct fmt::formatter<utf::format_view<Char>, char> {
+	utf::on_error errors{utf::on_error::replace};
+
+	constexpr auto parse(fmt::format_parse_context& ctx) {
+		auto it = ctx.begin();
+		if (!utf::detail::parse_format_errors(it, ctx.end(), errors))
+			throw fmt::format_error("invalid format for UTF string");
+		return it;
+	}
+
+	template <typename FormatContext>
+	auto format(utf::format_view<Char> const& view, FormatContext& ctx) const {
+		auto out = ctx.out();
+		if (!utf::detail::format_utf8_to(out, view.src, errors))
+			throw fmt::format_error("ill-formed UTF string");
+		return out;
+	}
+};
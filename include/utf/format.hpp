@@ -0,0 +1,111 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <algorithm>
+#include <utf/utf.hpp>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+namespace utf {
+	/*
+	 * Formatting argument, which writes the contents of the view to a
+	 * char-based format output as UTF-8.
+	 */
+	template <typename Char>
+	struct format_view {
+		std::basic_string_view<Char> src;
+	};
+
+	inline format_view<char16_t> formatted(std::u16string_view src) noexcept {
+		return {src};
+	}
+
+	inline format_view<char32_t> formatted(std::u32string_view src) noexcept {
+		return {src};
+	}
+
+	inline format_view<wchar_t> formatted(std::wstring_view src) noexcept {
+		return {src};
+	}
+
+#ifdef __cpp_lib_char8_t
+	inline format_view<char8_t> formatted(std::u8string_view src) noexcept {
+		return {src};
+	}
+#endif
+
+	namespace detail {
+		/*
+		 * Parses the "l" (lossy, default) or "s" (strict) presentation type;
+		 * returns false on any other specification.
+		 */
+		template <typename It>
+		constexpr bool parse_format_errors(It& it, It end, on_error& errors) {
+			if (it != end && *it != '}') {
+				if (*it == 'l')
+					errors = on_error::replace;
+				else if (*it == 's')
+					errors = on_error::stop;
+				else
+					return false;
+				++it;
+			}
+			return it == end || *it == '}';
+		}
+
+		/*
+		 * Transcodes the input in blocks of a fixed-size buffer and copies
+		 * each block to the output; returns false, if the input is ill-formed
+		 * and errors are not replaced.
+		 */
+		template <typename Char, typename OutputIt>
+		bool format_utf8_to(OutputIt& out,
+		                    std::basic_string_view<Char> src,
+		                    on_error errors) {
+			char block[256];
+			while (!src.empty()) {
+				auto const result = transcode(src, block, sizeof(block), errors);
+				out = std::copy_n(block, result.written, out);
+				src.remove_prefix(result.read);
+
+				switch (result.status) {
+					case transcode_status::ok:
+					case transcode_status::output_full:
+						break;
+					case transcode_status::incomplete:
+						if (errors == on_error::stop) return false;
+						out = std::copy_n("\xEF\xBF\xBD", 3, out);
+						return true;
+					case transcode_status::invalid:
+						return false;
+				}
+			}
+			return true;
+		}
+	}  // namespace detail
+}  // namespace utf
+
+#ifdef __cpp_lib_format
+template <typename Char>
+struct std::formatter<utf::format_view<Char>, char> {
+	utf::on_error errors{utf::on_error::replace};
+
+	constexpr auto parse(std::format_parse_context& ctx) {
+		auto it = ctx.begin();
+		if (!utf::detail::parse_format_errors(it, ctx.end(), errors))
+			throw std::format_error("invalid format for UTF string");
+		return it;
+	}
+
+	template <typename FormatContext>
+	auto format(utf::format_view<Char> const& view, FormatContext& ctx) const {
+		auto out = ctx.out();
+		if (!utf::detail::format_utf8_to(out, view.src, errors))
+			throw std::format_error("ill-formed UTF string");
+		return out;
+	}
+};
+#endif  // __cpp_lib_format
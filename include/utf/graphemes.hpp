@@ -0,0 +1,107 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace utf {
+	/*
+	 * Length, in units, of the extended grapheme cluster at the start of
+	 * the text, as defined by UAX #29 for Unicode 15.0; zero for empty
+	 * text. An ill-formed sequence is a cluster of its own.
+	 */
+	std::size_t grapheme_length(std::string_view src) noexcept;
+	std::size_t grapheme_length(std::u16string_view src) noexcept;
+	std::size_t grapheme_length(std::u32string_view src) noexcept;
+
+	std::size_t count_graphemes(std::string_view src) noexcept;
+	std::size_t count_graphemes(std::u16string_view src) noexcept;
+	std::size_t count_graphemes(std::u32string_view src) noexcept;
+
+#ifdef __cpp_lib_char8_t
+	std::size_t grapheme_length(std::u8string_view src) noexcept;
+	std::size_t count_graphemes(std::u8string_view src) noexcept;
+#endif
+
+	template <typename Char>
+	class grapheme_range {
+	public:
+		using view_type = std::basic_string_view<Char>;
+
+		class iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = view_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = view_type const*;
+			using reference = view_type const&;
+
+			iterator() = default;
+			explicit iterator(view_type rest) noexcept : rest_{rest} {
+				next();
+			}
+
+			reference operator*() const noexcept { return cluster_; }
+			pointer operator->() const noexcept { return &cluster_; }
+
+			iterator& operator++() noexcept {
+				rest_.remove_prefix(cluster_.size());
+				next();
+				return *this;
+			}
+
+			iterator operator++(int) noexcept {
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			bool operator==(iterator const& rhs) const noexcept {
+				return rest_.size() == rhs.rest_.size();
+			}
+			bool operator!=(iterator const& rhs) const noexcept {
+				return !(*this == rhs);
+			}
+
+		private:
+			void next() noexcept {
+				cluster_ = rest_.substr(0, grapheme_length(rest_));
+			}
+
+			view_type rest_{};
+			view_type cluster_{};
+		};
+
+		explicit grapheme_range(view_type src) noexcept : src_{src} {}
+
+		iterator begin() const noexcept { return iterator{src_}; }
+		iterator end() const noexcept {
+			return iterator{src_.substr(src_.size())};
+		}
+
+	private:
+		view_type src_;
+	};
+
+	inline grapheme_range<char> graphemes(std::string_view src) noexcept {
+		return grapheme_range<char>{src};
+	}
+
+	inline grapheme_range<char16_t> graphemes(
+	    std::u16string_view src) noexcept {
+		return grapheme_range<char16_t>{src};
+	}
+
+	inline grapheme_range<char32_t> graphemes(
+	    std::u32string_view src) noexcept {
+		return grapheme_range<char32_t>{src};
+	}
+
+#ifdef __cpp_lib_char8_t
+	inline grapheme_range<char8_t> graphemes(std::u8string_view src) noexcept {
+		return grapheme_range<char8_t>{src};
+	}
+#endif
+}  // namespace utf
@@ -0,0 +1,18 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace utf {
+	std::string json_escape(std::string_view src);
+	std::string json_escape(std::u16string_view src);
+	std::string json_escape(std::u32string_view src);
+	std::string json_unescape(std::string_view src);
+	std::u16string json_unescape_u16(std::string_view src);
+
+#ifdef __cpp_lib_char8_t
+	std::string json_escape(std::u8string_view src);
+#endif
+}  // namespace utf
@@ -0,0 +1,84 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <string_view>
+#include <vector>
+
+namespace utf {
+	enum class column_unit { code_points, utf16 };
+
+	struct line_column {
+		std::size_t line{};
+		std::size_t column{};
+	};
+
+	/*
+	 * Maps offsets in a UTF-8 or UTF-16 buffer to lines and columns and
+	 * back. Lines end after '\n'; columns are counted in code points or in
+	 * UTF-16 units from the start of the line. Besides the line starts, the
+	 * index keeps running counts every few hundred units, so a query only
+	 * decodes the units after the nearest of them.
+	 *
+	 * The index keeps a view of the buffer, which has to outlive it; after
+	 * an edit, update() takes the new buffer and the edited range.
+	 */
+	template <typename Char>
+	class basic_line_index {
+	public:
+		using view_type = std::basic_string_view<Char>;
+
+		basic_line_index() = default;
+		explicit basic_line_index(view_type text);
+
+		std::size_t lines() const noexcept { return line_starts_.size(); }
+		std::size_t line_start(std::size_t line) const noexcept;
+
+		// offsets inside a code point are treated as its start
+		line_column position(
+		    std::size_t offset,
+		    column_unit unit = column_unit::code_points) const noexcept;
+		// columns past the end of the line give the end of the line
+		std::size_t offset(
+		    line_column position,
+		    column_unit unit = column_unit::code_points) const noexcept;
+
+		/*
+		 * Catches up with an edit, which replaced `removed` units at the
+		 * offset with `inserted` new ones; only the lines and counts around
+		 * the edit are rebuilt, the ones after it are moved.
+		 */
+		void update(view_type text,
+		            std::size_t offset,
+		            std::size_t removed,
+		            std::size_t inserted);
+
+	private:
+		struct checkpoint {
+			std::size_t offset{};
+			std::size_t code_points{};
+			std::size_t utf16{};
+		};
+
+		void find_lines(std::size_t begin,
+		                std::size_t end,
+		                std::vector<std::size_t>& starts) const;
+		checkpoint add_checkpoints(
+		    checkpoint from,
+		    std::size_t end,
+		    std::vector<checkpoint>& out,
+		    std::vector<std::size_t>* starts = nullptr) const;
+		checkpoint counts_at(std::size_t offset) const noexcept;
+		checkpoint next_code_point(checkpoint at) const noexcept;
+
+		view_type text_{};
+		std::vector<std::size_t> line_starts_{0};
+		std::vector<checkpoint> checkpoints_{checkpoint{}};
+	};
+
+	using line_index = basic_line_index<char>;
+	using u16line_index = basic_line_index<char16_t>;
+
+	extern template class basic_line_index<char>;
+	extern template class basic_line_index<char16_t>;
+}  // namespace utf
@@ -0,0 +1,48 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace utf {
+	/*
+	 * The quick check of UAX #15 (Unicode 15.0): true, when the text is
+	 * known to be in NFC without normalizing it. False for ill-formed text
+	 * and for text, which might need normalizing.
+	 */
+	bool is_nfc_quick(std::string_view src) noexcept;
+	bool is_nfc_quick(std::u16string_view src) noexcept;
+	bool is_nfc_quick(std::u32string_view src) noexcept;
+
+	/*
+	 * Text passing the quick check comes back as it is, without touching
+	 * the buffer; otherwise the result is written to the buffer and the
+	 * returned view points into it. Ill-formed text gives an empty view.
+	 */
+	std::string_view to_nfc(std::string_view src, std::string& buffer);
+	std::u16string_view to_nfc(std::u16string_view src,
+	                           std::u16string& buffer);
+	std::u32string_view to_nfc(std::u32string_view src,
+	                           std::u32string& buffer);
+	std::string_view to_nfd(std::string_view src, std::string& buffer);
+	std::u16string_view to_nfd(std::u16string_view src,
+	                           std::u16string& buffer);
+	std::u32string_view to_nfd(std::u32string_view src,
+	                           std::u32string& buffer);
+
+	std::string to_nfc(std::string_view src);
+	std::u16string to_nfc(std::u16string_view src);
+	std::u32string to_nfc(std::u32string_view src);
+	std::string to_nfd(std::string_view src);
+	std::u16string to_nfd(std::u16string_view src);
+	std::u32string to_nfd(std::u32string_view src);
+
+#ifdef __cpp_lib_char8_t
+	bool is_nfc_quick(std::u8string_view src) noexcept;
+	std::u8string_view to_nfc(std::u8string_view src, std::u8string& buffer);
+	std::u8string_view to_nfd(std::u8string_view src, std::u8string& buffer);
+	std::u8string to_nfc(std::u8string_view src);
+	std::u8string to_nfd(std::u8string_view src);
+#endif
+}  // namespace utf
@@ -0,0 +1,68 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <functional>
+#include <string_view>
+#include <utf/utf.hpp>
+#include <vector>
+
+namespace utf {
+	/*
+	 * A piece of memory laid out like struct iovec (the base, then the
+	 * length), so a vector of them can be handed to writev as it is.
+	 */
+	struct segment {
+		void* base{};
+		std::size_t length{};
+	};
+
+	/*
+	 * Called for the next buffer, whenever the current one is full; an
+	 * empty segment means there are no more buffers.
+	 */
+	using segment_source = std::function<segment()>;
+
+	enum class code_point_split { never, allowed };
+
+	/*
+	 * The segments list the used part of each buffer, in order; buffers
+	 * left empty are not listed. With no more buffers, the status is
+	 * output_full and `read` tells where to continue.
+	 */
+	struct segments_result {
+		std::vector<segment> segments;
+		std::size_t read{};
+		std::size_t written{};
+		transcode_status status{transcode_status::ok};
+	};
+
+	/*
+	 * Writes UTF-8 into the buffers given by `next`. A code point which
+	 * does not fit at the end of a buffer goes to the next one, unless
+	 * splitting is allowed; then every buffer is filled to the end.
+	 */
+	segments_result transcode_segments(
+	    std::string_view src,
+	    segment_source const& next,
+	    on_error errors = on_error::stop,
+	    code_point_split split = code_point_split::never);
+	segments_result transcode_segments(
+	    std::u16string_view src,
+	    segment_source const& next,
+	    on_error errors = on_error::stop,
+	    code_point_split split = code_point_split::never);
+	segments_result transcode_segments(
+	    std::u32string_view src,
+	    segment_source const& next,
+	    on_error errors = on_error::stop,
+	    code_point_split split = code_point_split::never);
+
+#ifdef __cpp_lib_char8_t
+	segments_result transcode_segments(
+	    std::u8string_view src,
+	    segment_source const& next,
+	    on_error errors = on_error::stop,
+	    code_point_split split = code_point_split::never);
+#endif
+}  // namespace utf
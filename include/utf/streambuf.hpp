@@ -0,0 +1,63 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <streambuf>
+#include <string>
+#include <utf/utf.hpp>
+#include <vector>
+
+namespace utf {
+	/*
+	 * UTF-8 stream buffer over another stream buffer, which holds the text
+	 * in the external encoding. Reading and writing goes through internal
+	 * blocks, with partial units and sequences carried over to the next
+	 * block, so the memory used does not depend on the size of the stream.
+	 */
+	class transcoding_streambuf : public std::streambuf {
+	public:
+		static constexpr std::size_t default_block_size = 64 * 1024;
+
+		explicit transcoding_streambuf(
+		    std::streambuf* underlying,
+		    encoding external,
+		    on_error errors = on_error::replace,
+		    std::size_t block_size = default_block_size);
+		~transcoding_streambuf() override;
+
+		transcoding_streambuf(transcoding_streambuf const&) = delete;
+		transcoding_streambuf& operator=(transcoding_streambuf const&) =
+		    delete;
+
+		// Writes out the sequence left unfinished at the end of the output.
+		bool finish();
+		bool failed() const noexcept { return failed_; }
+
+	protected:
+		int_type underflow() override;
+		int_type overflow(int_type ch) override;
+		int sync() override;
+
+	private:
+		std::size_t decode_block(bool final);
+		bool encode_block(bool final);
+		template <typename CharIn>
+		transcode_result emit(std::basic_string_view<CharIn> src);
+
+		std::streambuf* underlying_;
+		encoding external_;
+		on_error errors_;
+		bool eof_{false};
+		bool failed_{false};
+
+		std::vector<char> get_area_;
+		std::vector<char> raw_in_;
+		std::size_t raw_in_size_{};
+
+		std::vector<char> put_area_;
+		std::vector<char> raw_out_;
+
+		std::u16string scratch16_;
+		std::u32string scratch32_;
+	};
+}  // namespace utf
@@ -0,0 +1,41 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <memory>
+#include <string>
+#include <utf/utf.hpp>
+
+namespace utf {
+	/*
+	 * Immutable string, which keeps the encoding it was created with and
+	 * converts to the other ones on first request, once, even if asked from
+	 * many threads at the same time. Copies share the value together with
+	 * the conversions already made. Ill-formed input gives an empty text.
+	 */
+	class text {
+	public:
+		text() noexcept = default;
+		explicit text(std::string_view src);
+		explicit text(std::u16string_view src);
+		explicit text(std::u32string_view src);
+#ifdef __cpp_lib_char8_t
+		explicit text(std::u8string_view src) : text{as_str8_view(src)} {}
+#endif
+
+		std::string_view str8() const;
+		std::u16string_view u16() const;
+		std::u32string_view u32() const;
+#ifdef __cpp_lib_char8_t
+		std::u8string_view u8() const { return as_u8_view(str8()); }
+#endif
+
+		bool empty() const noexcept;
+		std::size_t code_points() const noexcept;
+		bool is_ascii() const noexcept;
+
+	private:
+		struct impl;
+		std::shared_ptr<impl> impl_;
+	};
+}  // namespace utf
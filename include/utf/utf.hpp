@@ -2,14 +2,72 @@
 // This code is licensed under MIT license (see LICENSE for details)
 
 #pragma once
+#include <cstddef>
+#include <iterator>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace utf {
+	inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	enum class on_error { stop, replace };
+
+	enum class encoding { utf8, utf16le, utf16be, utf32le, utf32be };
+
+	/*
+	 * Relatives of UTF-8: WTF-8 keeps unpaired surrogates of ill-formed
+	 * UTF-16, CESU-8 stores supplementary characters as two three-byte
+	 * surrogates and Java's modified UTF-8 is CESU-8 with U+0000 written as
+	 * C0 80 (and, like Java strings, with unpaired surrogates allowed).
+	 */
+	enum class utf8_variant { strict, wtf8, cesu8, mutf8 };
+
+	enum class transcode_status {
+		ok,
+		output_full,
+		incomplete,
+		invalid,
+	};
+
+	struct transcode_result {
+		std::size_t read{};
+		std::size_t written{};
+		transcode_status status{transcode_status::ok};
+	};
+
+	struct find_result {
+		std::size_t units{npos};
+		std::size_t code_points{npos};
+
+		constexpr explicit operator bool() const noexcept {
+			return units != npos;
+		}
+	};
+
 	bool is_valid(std::string_view src);
 	bool is_valid(std::u16string_view src);
 	bool is_valid(std::u32string_view src);
 
+	/*
+	 * Copy of the UTF-32 string with every surrogate and every value above
+	 * U+10FFFF replaced with U+FFFD.
+	 */
+	std::u32string sanitize(std::u32string_view src);
+
+	/*
+	 * Offset of the first ill-formed sequence, or npos for valid UTF-8.
+	 * Large inputs are validated in slices on up to that many threads
+	 * (zero for one per core); a worker stops as soon as another one finds
+	 * an error earlier in the input.
+	 */
+	std::size_t invalid_offset(std::string_view src, unsigned threads = 1);
+
+	/*
+	 * Offset of the first unpaired surrogate, or npos for valid UTF-16.
+	 */
+	std::size_t invalid_offset(std::u16string_view src);
+
 	std::u16string as_u16(std::string_view src);
 	std::u32string as_u32(std::string_view src);
 	std::string as_str8(std::u16string_view src);
@@ -17,8 +75,99 @@ namespace utf {
 	std::u16string as_u16(std::u32string_view src);
 	std::string as_str8(std::u32string_view src);
 
+	/*
+	 * UTF-8 is decoded in blocks of 64 bytes, each sent to the routine for
+	 * the longest sequence found in it. The profile counts the blocks of
+	 * each kind, adding to what it held before.
+	 */
+	struct block_profile {
+		std::size_t ascii{};
+		std::size_t two_byte{};
+		std::size_t three_byte{};
+		std::size_t four_byte{};
+	};
+
+	std::u16string as_u16(std::string_view src, block_profile& profile);
+	std::u32string as_u32(std::string_view src, block_profile& profile);
+
+	/*
+	 * transcode() of inputs of at least that many bytes (32 MiB by
+	 * default) stores the output with non-temporal stores, bypassing the
+	 * cache, and prefetches the input ahead of the decoder. Such large
+	 * outputs are rarely read back soon, and writing them through the
+	 * cache evicts the working sets of other threads. The as_* functions
+	 * do the same where the standard library has resize_and_overwrite, and
+	 * can leave the new string uninitialized; UTF-8 decoded to UTF-16 or
+	 * UTF-32 is not affected. npos turns it off. streamed_conversions()
+	 * counts the conversions, which went that way.
+	 */
+	void set_streaming_threshold(std::size_t bytes) noexcept;
+	std::size_t streaming_threshold() noexcept;
+	std::size_t streamed_conversions() noexcept;
+
+	bool is_valid(std::wstring_view src);
+
+	template <typename CharOut, typename CharIn>
+	transcode_result transcode(std::basic_string_view<CharIn> src,
+	                           CharOut* dst,
+	                           std::size_t dst_size,
+	                           on_error errors = on_error::stop);
+
+	/*
+	 * Converts the text to UTF-8 in its own storage: the first `written`
+	 * bytes of the buffer hold the result. If UTF-8 would outgrow the units
+	 * read so far, the conversion stops with output_full and the units from
+	 * `read` on are left untouched. A byte buffer is trimmed to the result,
+	 * when the whole text was converted.
+	 */
+	transcode_result as_str8_in_place(std::u16string& buffer);
+	transcode_result as_str8_in_place(std::u32string& buffer);
+	transcode_result as_str8_in_place(std::vector<std::byte>& buffer,
+	                                  encoding from);
+
+	std::wstring as_wstring(std::string_view src);
+	std::wstring as_wstring(std::u16string_view src);
+	std::wstring as_wstring(std::u32string_view src);
+	std::string as_str8(std::wstring_view src);
+	std::u16string as_u16(std::wstring_view src);
+	std::u32string as_u32(std::wstring_view src);
+
+	bool is_valid(std::string_view src, utf8_variant variant);
+	std::u16string as_u16(std::string_view src, utf8_variant variant);
+	std::u32string as_u32(std::string_view src, utf8_variant variant);
+	std::string as_str8(std::u16string_view src, utf8_variant variant);
+	std::string as_str8(std::u32string_view src, utf8_variant variant);
+	std::string as_str8(std::string_view src,
+	                    utf8_variant from,
+	                    utf8_variant to);
+
+	find_result find(std::string_view haystack, char32_t needle);
+	find_result find(std::string_view haystack, std::string_view needle);
+	find_result find(std::u16string_view haystack, char32_t needle);
+	find_result find(std::u16string_view haystack, std::u16string_view needle);
+	find_result find(std::u32string_view haystack, char32_t needle);
+	find_result find(std::u32string_view haystack, std::u32string_view needle);
+
+	std::size_t floor_boundary(std::string_view src, std::size_t units) noexcept;
+	std::size_t floor_boundary(std::u16string_view src,
+	                           std::size_t units) noexcept;
+	std::size_t floor_boundary(std::u32string_view src,
+	                           std::size_t units) noexcept;
+	std::size_t ceil_boundary(std::string_view src, std::size_t units) noexcept;
+	std::size_t ceil_boundary(std::u16string_view src,
+	                          std::size_t units) noexcept;
+	std::size_t ceil_boundary(std::u32string_view src,
+	                          std::size_t units) noexcept;
+	std::string_view truncate_to_units(std::string_view src,
+	                                   std::size_t units) noexcept;
+	std::u16string_view truncate_to_units(std::u16string_view src,
+	                                      std::size_t units) noexcept;
+	std::u32string_view truncate_to_units(std::u32string_view src,
+	                                      std::size_t units) noexcept;
+
 #ifdef __cpp_lib_char8_t
 	bool is_valid(std::u8string_view src);
+	std::size_t invalid_offset(std::u8string_view src, unsigned threads = 1);
 
 	std::string as_str8(std::u8string_view src);
 	std::u16string as_u16(std::u8string_view src);
@@ -26,5 +175,130 @@ namespace utf {
 	std::u8string as_u8(std::u16string_view src);
 	std::u8string as_u8(std::u32string_view src);
 	std::u8string as_u8(std::string_view src);
+	std::wstring as_wstring(std::u8string_view src);
+	std::u8string as_u8(std::wstring_view src);
+
+	struct validate_t {
+		explicit validate_t() = default;
+	};
+	inline constexpr validate_t validate{};
+
+	inline std::u8string_view as_u8_view(std::string_view src) noexcept {
+		return {reinterpret_cast<char8_t const*>(src.data()), src.size()};
+	}
+
+	inline std::string_view as_str8_view(std::u8string_view src) noexcept {
+		return {reinterpret_cast<char const*>(src.data()), src.size()};
+	}
+
+	inline std::u8string_view as_u8_view(std::string_view src, validate_t) {
+		if (!is_valid(src)) return {};
+		return as_u8_view(src);
+	}
+
+	inline std::string_view as_str8_view(std::u8string_view src, validate_t) {
+		if (!is_valid(src)) return {};
+		return as_str8_view(src);
+	}
+
+	find_result find(std::u8string_view haystack, char32_t needle);
+	find_result find(std::u8string_view haystack, std::u8string_view needle);
+
+	std::size_t floor_boundary(std::u8string_view src,
+	                           std::size_t units) noexcept;
+	std::size_t ceil_boundary(std::u8string_view src,
+	                          std::size_t units) noexcept;
+	std::u8string_view truncate_to_units(std::u8string_view src,
+	                                     std::size_t units) noexcept;
+#endif
+
+	template <typename Char>
+	class chunk_range {
+	public:
+		using view_type = std::basic_string_view<Char>;
+
+		class iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = view_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = view_type const*;
+			using reference = view_type const&;
+
+			iterator() = default;
+			iterator(view_type rest, std::size_t max_units) noexcept
+			    : rest_{rest}, max_units_{max_units} {
+				next();
+			}
+
+			reference operator*() const noexcept { return chunk_; }
+			pointer operator->() const noexcept { return &chunk_; }
+
+			iterator& operator++() noexcept {
+				rest_.remove_prefix(chunk_.size());
+				next();
+				return *this;
+			}
+
+			iterator operator++(int) noexcept {
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			bool operator==(iterator const& rhs) const noexcept {
+				return rest_.size() == rhs.rest_.size();
+			}
+			bool operator!=(iterator const& rhs) const noexcept {
+				return !(*this == rhs);
+			}
+
+		private:
+			void next() noexcept {
+				auto size = floor_boundary(rest_, max_units_);
+				// a single code point longer than the limit still has to
+				// make progress
+				if (!size && !rest_.empty()) size = ceil_boundary(rest_, 1);
+				chunk_ = rest_.substr(0, size);
+			}
+
+			view_type rest_{};
+			view_type chunk_{};
+			std::size_t max_units_{};
+		};
+
+		chunk_range(view_type src, std::size_t max_units) noexcept
+		    : src_{src}, max_units_{max_units} {}
+
+		iterator begin() const noexcept { return {src_, max_units_}; }
+		iterator end() const noexcept {
+			return {src_.substr(src_.size()), max_units_};
+		}
+
+	private:
+		view_type src_;
+		std::size_t max_units_;
+	};
+
+	inline chunk_range<char> chunks(std::string_view src,
+	                                std::size_t max_units) noexcept {
+		return {src, max_units};
+	}
+
+	inline chunk_range<char16_t> chunks(std::u16string_view src,
+	                                    std::size_t max_units) noexcept {
+		return {src, max_units};
+	}
+
+	inline chunk_range<char32_t> chunks(std::u32string_view src,
+	                                    std::size_t max_units) noexcept {
+		return {src, max_units};
+	}
+
+#ifdef __cpp_lib_char8_t
+	inline chunk_range<char8_t> chunks(std::u8string_view src,
+	                                   std::size_t max_units) noexcept {
+		return {src, max_units};
+	}
 #endif
 }  // namespace utf
@@ -0,0 +1,122 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <utf/utf.hpp>
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		inline std::size_t sequence_length(std::uint8_t lead) noexcept {
+			if (lead < 0xC0) return 1;
+			if (lead < 0xE0) return 2;
+			if (lead < 0xF0) return 3;
+			return 4;
+		}
+
+		/*
+		 * Looks back at most three bytes for the lead byte of the sequence
+		 * containing the unit at `units`. If that sequence would end at or
+		 * before `units` (e.g. in the middle of a run of stray continuation
+		 * bytes), cutting there does not split anything.
+		 */
+		template <typename Char>
+		std::size_t floor_utf8(std::basic_string_view<Char> src,
+		                       std::size_t units) noexcept {
+			if (units >= src.size()) return src.size();
+
+			auto const data = reinterpret_cast<std::uint8_t const*>(src.data());
+			auto pos = units;
+			for (int back = 0; back < 3 && pos > 0 &&
+			                   detail::is_continuation(data[pos]);
+			     ++back)
+				--pos;
+
+			if (pos == units || detail::is_continuation(data[pos]))
+				return units;
+			if (pos + sequence_length(data[pos]) > units) return pos;
+			return units;
+		}
+
+		template <typename Char>
+		std::size_t ceil_utf8(std::basic_string_view<Char> src,
+		                      std::size_t units) noexcept {
+			if (units >= src.size()) return src.size();
+
+			auto const pos = floor_utf8(src, units);
+			if (pos == units) return units;
+
+			auto const lead = static_cast<std::uint8_t>(src[pos]);
+			auto const end = pos + sequence_length(lead);
+			return end < src.size() ? end : src.size();
+		}
+	}  // namespace
+
+	std::size_t floor_boundary(std::string_view src,
+	                           std::size_t units) noexcept {
+		return floor_utf8(src, units);
+	}
+
+	std::size_t floor_boundary(std::u16string_view src,
+	                           std::size_t units) noexcept {
+		if (units >= src.size()) return src.size();
+		if (units > 0 && detail::is_low_surrogate(src[units]) &&
+		    (src[units - 1] & 0xFC00) == 0xD800)
+			return units - 1;
+		return units;
+	}
+
+	std::size_t floor_boundary(std::u32string_view src,
+	                           std::size_t units) noexcept {
+		return units < src.size() ? units : src.size();
+	}
+
+	std::size_t ceil_boundary(std::string_view src,
+	                          std::size_t units) noexcept {
+		return ceil_utf8(src, units);
+	}
+
+	std::size_t ceil_boundary(std::u16string_view src,
+	                          std::size_t units) noexcept {
+		if (units >= src.size()) return src.size();
+		auto const pos = floor_boundary(src, units);
+		return pos == units ? units : units + 1;
+	}
+
+	std::size_t ceil_boundary(std::u32string_view src,
+	                          std::size_t units) noexcept {
+		if (units >= src.size()) return src.size();
+		return units;
+	}
+
+	std::string_view truncate_to_units(std::string_view src,
+	                                   std::size_t units) noexcept {
+		return src.substr(0, floor_boundary(src, units));
+	}
+
+	std::u16string_view truncate_to_units(std::u16string_view src,
+	                                      std::size_t units) noexcept {
+		return src.substr(0, floor_boundary(src, units));
+	}
+
+	std::u32string_view truncate_to_units(std::u32string_view src,
+	                                      std::size_t units) noexcept {
+		return src.substr(0, floor_boundary(src, units));
+	}
+
+#ifdef __cpp_lib_char8_t
+	std::size_t floor_boundary(std::u8string_view src,
+	                           std::size_t units) noexcept {
+		return floor_utf8(src, units);
+	}
+
+	std::size_t ceil_boundary(std::u8string_view src,
+	                          std::size_t units) noexcept {
+		return ceil_utf8(src, units);
+	}
+
+	std::u8string_view truncate_to_units(std::u8string_view src,
+	                                     std::size_t units) noexcept {
+		return src.substr(0, floor_boundary(src, units));
+	}
+#endif  // __cpp_lib_char8_t
+}  // namespace utf
@@ -0,0 +1,123 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utf/cache.hpp>
+
+namespace utf {
+	namespace {
+		struct cache_entry {
+			std::string key;
+			std::shared_ptr<const std::u16string> value;
+			std::atomic<bool> referenced{false};
+		};
+	}  // namespace
+
+	struct conversion_cache::shard {
+		explicit shard(std::size_t capacity) : capacity{capacity} {
+			clock.reserve(capacity);
+		}
+
+		std::shared_ptr<const std::u16string> find(
+		    std::string_view key) const {
+			std::shared_lock lock{mutex};
+			auto it = entries.find(key);
+			if (it == entries.end()) return {};
+			it->second->referenced.store(true, std::memory_order_relaxed);
+			return it->second->value;
+		}
+
+		std::shared_ptr<const std::u16string> insert(
+		    std::string_view key,
+		    std::shared_ptr<const std::u16string> value) {
+			std::unique_lock lock{mutex};
+			// someone else might have converted the same string meanwhile
+			auto it = entries.find(key);
+			if (it != entries.end()) return it->second->value;
+
+			auto entry = std::make_unique<cache_entry>();
+			entry->key.assign(key);
+			entry->value = std::move(value);
+			auto const result = entry->value;
+
+			if (clock.size() < capacity) {
+				clock.push_back(entry.get());
+			} else {
+				// second chance for the entries used since the last sweep
+				while (clock[hand]->referenced.exchange(
+				    false, std::memory_order_relaxed))
+					hand = (hand + 1) % clock.size();
+				entries.erase(clock[hand]->key);
+				clock[hand] = entry.get();
+				hand = (hand + 1) % clock.size();
+			}
+
+			std::string_view const stored{entry->key};
+			entries.emplace(stored, std::move(entry));
+			return result;
+		}
+
+		std::size_t size() const {
+			std::shared_lock lock{mutex};
+			return entries.size();
+		}
+
+		void clear() {
+			std::unique_lock lock{mutex};
+			clock.clear();
+			entries.clear();
+			hand = 0;
+		}
+
+		std::size_t const capacity;
+		mutable std::shared_mutex mutex;
+		// keys are views of the strings owned by the entries
+		std::unordered_map<std::string_view, std::unique_ptr<cache_entry>>
+		    entries;
+		std::vector<cache_entry*> clock;
+		std::size_t hand{};
+	};
+
+	conversion_cache::conversion_cache(std::size_t capacity,
+	                                   std::size_t shards)
+	    : capacity_{capacity ? capacity : 1} {
+		if (!shards) shards = 1;
+		if (shards > capacity_) shards = capacity_;
+		// the first shards take one more entry each, so the capacities
+		// add up to the capacity of the cache
+		auto const per_shard = capacity_ / shards;
+		auto const remainder = capacity_ % shards;
+		shards_.reserve(shards);
+		for (std::size_t index = 0; index < shards; ++index)
+			shards_.push_back(std::make_unique<shard>(
+			    per_shard + (index < remainder ? 1 : 0)));
+	}
+
+	conversion_cache::~conversion_cache() = default;
+
+	std::shared_ptr<const std::u16string> conversion_cache::as_u16(
+	    std::string_view src) {
+		auto const hash = std::hash<std::string_view>{}(src);
+		auto& owner = *shards_[hash % shards_.size()];
+
+		if (auto found = owner.find(src)) return found;
+		return owner.insert(
+		    src, std::make_shared<const std::u16string>(utf::as_u16(src)));
+	}
+
+	std::size_t conversion_cache::size() const {
+		std::size_t result{};
+		for (auto const& owner : shards_)
+			result += owner->size();
+		return result;
+	}
+
+	void conversion_cache::clear() {
+		for (auto const& owner : shards_)
+			owner->clear();
+	}
+}  // namespace utf
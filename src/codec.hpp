@@ -0,0 +1,557 @@
+// Copyright (c) 2015 midnightBITS
+// Changes to the original code are licensed under MIT license (see LICENSE for
+// details), original code is licensed as follows:
+
+/*
+ * Copyright 2001-2004 Unicode, Inc.
+ *
+ * Disclaimer
+ *
+ * This source code is provided as is by Unicode, Inc. No claims are
+ * made as to fitness for any particular purpose. No warranties of any
+ * kind are expressed or implied. The recipient agrees to determine
+ * applicability of information provided. If this file has been
+ * purchased on magnetic or optical media from Unicode, Inc., the
+ * sole remedy for any claim will be exchange of defective media
+ * within 90 days of receipt.
+ *
+ * Limitations on Rights to Redistribute This Code
+ *
+ * Unicode, Inc. hereby grants the right to freely use the information
+ * supplied in this file in the creation of products supporting the
+ * Unicode Standard, and to make copies of this file in any form
+ * for internal or external distribution as long as this notice
+ * remains attached.
+ */
+
+/* ---------------------------------------------------------------------
+
+    Conversions between UTF32, UTF-16, and UTF-8. Shared decoding and
+    encoding routines.
+    Author: Mark E. Davis, 1994.
+    Rev History: Rick McGowan, fixes & updates May 2001.
+    Sept 2001: fixed const & error conditions per
+        mods suggested by S. Parent & A. Lillich.
+    June 2002: Tim Dodd added detection and handling of incomplete
+        source sequences, enhanced error detection, added casts
+        to eliminate compiler warnings.
+    July 2003: slight mods to back out aggressive FFFE detection.
+    Jan 2004: updated switches in from-UTF8 conversions.
+    Oct 2004: updated to use UNI_MAX_LEGAL_UTF32 in UTF-32 conversions.
+
+    See the header file "ConvertUTF.h" for complete documentation.
+
+------------------------------------------------------------------------ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utf/utf.hpp>
+#include "utf8_dfa.hpp"
+
+namespace utf {
+	using std::uint8_t;
+	/*
+	 * Index into the table below with the first byte of a UTF-8 sequence to
+	 * get the number of trailing bytes that are supposed to follow it.
+	 * Note that *legal* UTF-8 values can't have 4 or 5-bytes. The table is
+	 * left as-is for anyone who may want to do such conversion, which was
+	 * allowed in earlier algorithms.
+	 */
+	static constexpr const uint8_t trailingBytesForUTF8[256] = {
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 00
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 10
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 20
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 30
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 40
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 50
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 60
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 70
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 80
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 90
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // A0
+	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // B0
+	    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // C0
+	    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // D0
+	    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  // E0
+	    3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5   // F0
+	};
+
+	/*
+	 * Once the bits are split out into bytes of UTF-8, this is a mask OR-ed
+	 * into the first byte, depending on how many bytes follow.  There are
+	 * as many entries in this table as there are UTF-8 sequence types.
+	 * (I.e., one byte sequence, two byte... etc.). Remember that sequencs
+	 * for *legal* UTF-8 will be 4 or fewer bytes total.
+	 */
+	static constexpr const uint8_t firstByteMark[7] = {0x00, 0x00, 0xC0, 0xE0,
+	                                                   0xF0, 0xF8, 0xFC};
+
+	enum : char16_t {
+		UNI_SUR_HIGH_START = 0xD800,
+		UNI_SUR_HIGH_END = 0xDBFF,
+		UNI_SUR_LOW_START = 0xDC00,
+		UNI_SUR_LOW_END = 0xDFFF,
+	};
+
+	enum : char32_t {
+		UNI_REPLACEMENT_CHAR = 0x0000FFFD,
+		UNI_MAX_BMP = 0x0000FFFF,
+		UNI_MAX_UTF16 = 0x0010FFFF,
+		UNI_MAX_LEGAL_UTF32 = 0x0010FFFF
+	};
+
+	// used for shifting by 10 bits
+	static constexpr const unsigned halfShift = 10;
+
+	static constexpr const char32_t halfBase = 0x0001'0000UL;
+	static constexpr const char32_t halfMask = 0x3FFUL;
+	static constexpr const char32_t byteMask = 0xBF;
+	static constexpr const char32_t byteMark = 0x80;
+
+	template <typename T>
+	static bool isLegalUTF8(T source, int length) {
+		uint8_t a;
+		auto srcptr = source + length;
+		switch (length) {
+			default:
+				return false;
+				/* Everything else falls through when "true"... */
+			case 4:
+				if ((a = static_cast<uint8_t>(*--srcptr)) < 0x80 || a > 0xBF)
+					return false;
+				[[fallthrough]];
+			case 3:
+				if ((a = static_cast<uint8_t>(*--srcptr)) < 0x80 || a > 0xBF)
+					return false;
+				[[fallthrough]];
+			case 2:
+				if ((a = static_cast<uint8_t>(*--srcptr)) < 0x80 || a > 0xBF)
+					return false;
+
+				switch (static_cast<uint8_t>(*source)) {
+						/* no fall-through in this inner switch */
+					case 0xE0:
+						if (a < 0xA0) return false;
+						break;
+					case 0xED:
+						if (a > 0x9F) return false;
+						break;
+					case 0xF0:
+						if (a < 0x90) return false;
+						break;
+					case 0xF4:
+						if (a > 0x8F) return false;
+						break;
+					default:
+						if (a < 0x80) return false;
+				}
+				[[fallthrough]];
+
+			case 1:
+				if (static_cast<uint8_t>(*source) >= 0x80 &&
+				    static_cast<uint8_t>(*source) < 0xC2)
+					return false;
+		}
+		if (static_cast<uint8_t>(*source) > 0xF4) return false;
+		return true;
+	}
+
+	/*
+	 * Runs the DFA over one sequence; on error, the source is left as it
+	 * was.
+	 */
+	template <typename It>
+	static inline char32_t decode_utf8(It& source, It sourceEnd, bool& ok) {
+		auto it = source;
+		std::uint32_t state = detail::utf8_accept;
+		char32_t ch = 0;
+		if (sourceEnd - it >= 4) {
+			// a sequence ends within four bytes, one way or another
+			do {
+				state =
+				    detail::utf8_step(state, ch, static_cast<uint8_t>(*it++));
+			} while (state > detail::utf8_reject);
+		} else {
+			do {
+				if (it == sourceEnd) {
+					ok = false;
+					return 0;
+				}
+				state =
+				    detail::utf8_step(state, ch, static_cast<uint8_t>(*it++));
+			} while (state > detail::utf8_reject);
+		}
+
+		ok = state == detail::utf8_accept;
+		if (!ok) return 0;
+		source = it;
+		return ch;
+	}
+
+	using str8_it = std::string_view::const_iterator;
+	static inline char32_t decode(str8_it& source,
+	                              str8_it sourceEnd,
+	                              bool& ok) {
+		return decode_utf8(source, sourceEnd, ok);
+	}
+
+#ifdef __cpp_lib_char8_t
+	using utf8_it = std::u8string_view::const_iterator;
+	static inline char32_t decode(utf8_it& source,
+	                              utf8_it sourceEnd,
+	                              bool& ok) {
+		return decode_utf8(source, sourceEnd, ok);
+	}
+#endif  // __cpp_lib_char8_t
+
+	template <typename It>
+	static inline char32_t decode_utf16(It& source, It sourceEnd, bool& ok) {
+		ok = true;
+		char32_t ch = static_cast<char16_t>(*source++);
+		/* If we have a surrogate pair, convert to char32_t first. */
+		if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_HIGH_END) {
+			ok = false;
+			/* If the 16 bits following the high surrogate are in the source
+			 * buffer... */
+			if (source < sourceEnd) {
+				char32_t trail = static_cast<char16_t>(*source);
+				/* If it's a low surrogate, convert to char32_t. */
+				if (trail >= UNI_SUR_LOW_START && trail <= UNI_SUR_LOW_END) {
+					ch = ((ch - UNI_SUR_HIGH_START) << halfShift) + trail -
+					     UNI_SUR_LOW_START + halfBase;
+					++source;
+					ok = true;
+				}
+			}
+		} else if (ch >= UNI_SUR_LOW_START && ch <= UNI_SUR_LOW_END) {
+			/* A low surrogate with no high one before it. */
+			ok = false;
+		}
+
+		return ch;
+	}
+
+	using utf16_it = std::u16string_view::const_iterator;
+	static inline char32_t decode(utf16_it& source,
+	                              utf16_it sourceEnd,
+	                              bool& ok) {
+		return decode_utf16(source, sourceEnd, ok);
+	}
+
+	using utf32_it = std::u32string_view::const_iterator;
+	static inline char32_t decode(utf32_it& source,
+	                              utf32_it /* sourceEnd */,
+	                              bool& ok) {
+		ok = true;
+		return *source++;
+	}
+
+	/*
+	 * wchar_t is either UTF-16 (Windows) or UTF-32 (everywhere else); the
+	 * engine is chosen at compile time.
+	 */
+	using wide_it = std::wstring_view::const_iterator;
+	static inline char32_t decode(wide_it& source,
+	                              wide_it sourceEnd,
+	                              bool& ok) {
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+			return decode_utf16(source, sourceEnd, ok);
+		} else {
+			ok = true;
+			return static_cast<char32_t>(*source++);
+		}
+	}
+
+	template <typename Unit>
+	static inline unsigned encode_utf8(char32_t ch, Unit* target) {
+		unsigned short bytesToWrite = 0;
+
+		/* Figure out how many bytes the result will require */
+		if (ch < 0x80u)
+			bytesToWrite = 1;
+		else if (ch < 0x800u)
+			bytesToWrite = 2;
+		else if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END) {
+			bytesToWrite = 3;
+			ch = UNI_REPLACEMENT_CHAR;
+		} else if (ch < 0x10000u)
+			bytesToWrite = 3;
+		else if (ch <= UNI_MAX_LEGAL_UTF32)
+			bytesToWrite = 4;
+		else {
+			bytesToWrite = 3;
+			ch = UNI_REPLACEMENT_CHAR;
+		}
+
+		Unit* midp = target + bytesToWrite;
+		switch (bytesToWrite) { /* note: everything falls through. */
+			case 4:
+				*--midp = static_cast<Unit>((ch | byteMark) & byteMask);
+				ch >>= 6;
+				[[fallthrough]];
+			case 3:
+				*--midp = static_cast<Unit>((ch | byteMark) & byteMask);
+				ch >>= 6;
+				[[fallthrough]];
+			case 2:
+				*--midp = static_cast<Unit>((ch | byteMark) & byteMask);
+				ch >>= 6;
+				[[fallthrough]];
+			case 1:
+				*--midp = static_cast<Unit>(ch | firstByteMark[bytesToWrite]);
+		}
+		return bytesToWrite;
+	}
+
+	template <typename Unit>
+	static inline unsigned encode_utf16(char32_t ch, Unit* target) {
+		if (ch <= UNI_MAX_BMP) {
+			/* UTF-16 surrogate values are illegal in UTF-32 */
+			if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END) {
+				*target = static_cast<Unit>(UNI_REPLACEMENT_CHAR);
+				return 1;
+			}
+			*target = static_cast<Unit>(ch); /* normal case */
+			return 1;
+		}
+
+		if (ch > UNI_MAX_UTF16) {
+			*target = static_cast<Unit>(UNI_REPLACEMENT_CHAR);
+			return 1;
+		}
+
+		ch -= halfBase;
+		*target++ = static_cast<Unit>((ch >> halfShift) + UNI_SUR_HIGH_START);
+		*target = static_cast<Unit>((ch & halfMask) + UNI_SUR_LOW_START);
+		return 2;
+	}
+
+	/*
+	 * Writes up to four units of the code point to the target, choosing the
+	 * encoding by the size of the unit, and returns the number of units
+	 * written. UTF-32 values are passed through unchanged.
+	 */
+	template <typename Unit>
+	static inline unsigned encode_units(char32_t ch, Unit* target) {
+		if constexpr (sizeof(Unit) == 1) {
+			return encode_utf8(ch, target);
+		} else if constexpr (sizeof(Unit) == 2) {
+			return encode_utf16(ch, target);
+		} else if constexpr (std::is_same_v<Unit, char32_t>) {
+			*target = ch;
+			return 1;
+		} else {
+			*target = static_cast<Unit>(ch);
+			return 1;
+		}
+	}
+
+	template <typename String>
+	static inline void encode(char32_t ch,
+	                          std::back_insert_iterator<String>& target) {
+		typename String::value_type units[4];
+		auto const length = encode_units(ch, units);
+		for (unsigned i = 0; i < length; ++i)
+			*target++ = units[i];
+	}
+
+	static inline void encode(
+	    char32_t ch,
+	    std::back_insert_iterator<std::u32string>& target) {
+		/*
+		 * UTF-16 surrogate values are illegal in UTF-32, and anything over
+		 * Plane 17 (> 0x10FFFF) is illegal.
+		 */
+		if (ch > UNI_MAX_LEGAL_UTF32 ||
+		    (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END)) {
+			*target++ = UNI_REPLACEMENT_CHAR;
+			return;
+		}
+		*target++ = ch; /* normal case */
+	}
+
+	/*
+	 * Tells, if the failed sequence at source is only cut short by the end
+	 * of the input, that is, more input could still make it legal.
+	 */
+	template <typename It>
+	static inline bool is_truncated(It source, It sourceEnd) {
+		if constexpr (sizeof(*source) == 1) {
+			auto const uchar = static_cast<uint8_t>(*source);
+			if (uchar < 0xC2 || uchar > 0xF4) return false;
+			auto const available = sourceEnd - source;
+			if (trailingBytesForUTF8[uchar] < available) return false;
+			return isLegalUTF8(source, static_cast<int>(available));
+		} else if constexpr (sizeof(*source) == 2) {
+			auto const unit = static_cast<char16_t>(*source);
+			return sourceEnd - source == 1 && unit >= UNI_SUR_HIGH_START &&
+			       unit <= UNI_SUR_HIGH_END;
+		} else {
+			return false;
+		}
+	}
+
+	/*
+	 * Length of the maximal subpart of an ill-formed sequence, which is
+	 * replaced with a single U+FFFD.
+	 */
+	template <typename It>
+	static inline std::ptrdiff_t invalid_length(It source, It sourceEnd) {
+		if constexpr (sizeof(*source) == 1) {
+			auto const uchar = static_cast<uint8_t>(*source);
+			if (uchar < 0xC2 || uchar > 0xF4) return 1;
+			auto length = std::ptrdiff_t{trailingBytesForUTF8[uchar]} + 1;
+			if (length > sourceEnd - source) length = sourceEnd - source;
+			for (; length > 1; --length) {
+				if (isLegalUTF8(source, static_cast<int>(length))) break;
+			}
+			return length;
+		} else {
+			return 1;
+		}
+	}
+
+	/*
+	 * Three-byte form of any BMP value, surrogates included, as used by the
+	 * relatives of UTF-8.
+	 */
+	template <typename Unit>
+	static inline unsigned encode_surrogate_utf8(char32_t ch, Unit* target) {
+		target[0] = static_cast<Unit>(0xE0 | (ch >> 12));
+		target[1] = static_cast<Unit>(0x80 | ((ch >> 6) & 0x3F));
+		target[2] = static_cast<Unit>(0x80 | (ch & 0x3F));
+		return 3;
+	}
+
+	template <typename It>
+	static inline bool is_surrogate_utf8(It source,
+	                                     It sourceEnd,
+	                                     uint8_t low,
+	                                     uint8_t high) {
+		if (sourceEnd - source < 3 || static_cast<uint8_t>(source[0]) != 0xED)
+			return false;
+		auto const second = static_cast<uint8_t>(source[1]);
+		auto const third = static_cast<uint8_t>(source[2]);
+		return second >= low && second <= high && (third & 0xC0) == 0x80;
+	}
+
+	template <typename It>
+	static inline char32_t surrogate_utf8_value(It source) {
+		return 0xD000 | ((static_cast<char32_t>(source[1]) & 0x3F) << 6) |
+		       (static_cast<char32_t>(source[2]) & 0x3F);
+	}
+
+	/*
+	 * Decodes one code point of the given relative of UTF-8. Unpaired
+	 * surrogates, where the variant allows them, are returned as they are;
+	 * the source is left untouched on error.
+	 */
+	template <typename It>
+	static inline char32_t decode_variant(It& source,
+	                                      It sourceEnd,
+	                                      utf8_variant variant,
+	                                      bool& ok) {
+		ok = false;
+		auto const uchar = static_cast<uint8_t>(*source);
+		if (variant == utf8_variant::mutf8) {
+			if (uchar == 0) return 0;
+			if (uchar == 0xC0) {
+				if (sourceEnd - source < 2 ||
+				    static_cast<uint8_t>(source[1]) != 0x80)
+					return 0;
+				source += 2;
+				ok = true;
+				return 0;
+			}
+		}
+
+		if (!is_surrogate_utf8(source, sourceEnd, 0xA0, 0xBF)) {
+			// supplementary characters are surrogate pairs in CESU-8
+			if (uchar >= 0xF0 && (variant == utf8_variant::cesu8 ||
+			                      variant == utf8_variant::mutf8))
+				return 0;
+			auto next = source;
+			auto const ch = decode(next, sourceEnd, ok);
+			if (ok) source = next;
+			return ch;
+		}
+
+		if (variant == utf8_variant::strict) return 0;
+
+		auto const lead = surrogate_utf8_value(source);
+		auto const paired =
+		    lead <= UNI_SUR_HIGH_END &&
+		    is_surrogate_utf8(source + 3, sourceEnd, 0xB0, 0xBF);
+
+		switch (variant) {
+			case utf8_variant::wtf8:
+				// a pair written as two surrogates is not WTF-8
+				if (paired) return 0;
+				break;
+			case utf8_variant::cesu8:
+				if (!paired) return 0;
+				[[fallthrough]];
+			default:
+				if (paired) {
+					auto const trail = surrogate_utf8_value(source + 3);
+					source += 6;
+					ok = true;
+					return ((lead - UNI_SUR_HIGH_START) << halfShift) + trail -
+					       UNI_SUR_LOW_START + halfBase;
+				}
+		}
+
+		source += 3;
+		ok = true;
+		return lead;
+	}
+
+	/*
+	 * Writes up to six bytes of the code point in the given relative of
+	 * UTF-8; returns zero, if the variant cannot represent it.
+	 */
+	template <typename Unit>
+	static inline unsigned encode_variant(char32_t ch,
+	                                      Unit* target,
+	                                      utf8_variant variant) {
+		auto const surrogate =
+		    ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END;
+		if (ch > UNI_MAX_LEGAL_UTF32) return 0;
+
+		switch (variant) {
+			case utf8_variant::strict:
+				if (surrogate) return 0;
+				break;
+			case utf8_variant::wtf8:
+				if (surrogate) return encode_surrogate_utf8(ch, target);
+				break;
+			case utf8_variant::cesu8:
+			case utf8_variant::mutf8:
+				if (variant == utf8_variant::mutf8) {
+					if (surrogate) return encode_surrogate_utf8(ch, target);
+					if (ch == 0) {
+						target[0] = static_cast<Unit>(0xC0);
+						target[1] = static_cast<Unit>(0x80);
+						return 2;
+					}
+				}
+				if (surrogate) return 0;
+				if (ch >= halfBase) {
+					ch -= halfBase;
+					encode_surrogate_utf8(
+					    (ch >> halfShift) + UNI_SUR_HIGH_START, target);
+					return 3 + encode_surrogate_utf8(
+					               (ch & halfMask) + UNI_SUR_LOW_START,
+					               target + 3);
+				}
+				break;
+		}
+
+		return encode_utf8(ch, target);
+	}
+}  // namespace utf
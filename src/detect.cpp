@@ -0,0 +1,181 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <algorithm>
+#include <utf/detect.hpp>
+#include "simd.hpp"
+#include "utf8_dfa.hpp"
+
+namespace utf {
+	using namespace ::std::literals;
+
+	namespace {
+		struct bom_info {
+			std::string_view bytes;
+			encoding enc;
+		};
+
+		// the UTF-32LE mark starts with the UTF-16LE one, so it goes first
+		constexpr bom_info boms[] = {
+		    {"\xFF\xFE\x00\x00"sv, encoding::utf32le},
+		    {"\x00\x00\xFE\xFF"sv, encoding::utf32be},
+		    {"\xEF\xBB\xBF"sv, encoding::utf8},
+		    {"\xFF\xFE"sv, encoding::utf16le},
+		    {"\xFE\xFF"sv, encoding::utf16be},
+		};
+
+		struct utf16_check {
+			bool valid{true};
+			bool expect_low{false};
+
+			void step(char32_t unit) noexcept {
+				auto const high = unit >= 0xD800 && unit <= 0xDBFF;
+				auto const low = unit >= 0xDC00 && unit <= 0xDFFF;
+				if (expect_low != low) valid = false;
+				expect_low = high;
+			}
+		};
+
+		bool utf32_unit_valid(char32_t unit) noexcept {
+			return unit <= 0x10FFFF && (unit < 0xD800 || unit > 0xDFFF);
+		}
+
+		struct statistics {
+			std::size_t size{};
+			std::size_t zeros[4]{};
+			std::uint32_t utf8_state{detail::utf8_accept};
+			utf16_check utf16le{};
+			utf16_check utf16be{};
+			bool utf32le{true};
+			bool utf32be{true};
+
+			void pair(uint8_t const* bytes) noexcept {
+				auto const first = char32_t{bytes[0]};
+				auto const second = char32_t{bytes[1]};
+				utf16le.step(first | second << 8);
+				utf16be.step(second | first << 8);
+			}
+
+			void quad(uint8_t const* bytes) noexcept {
+				auto const le = char32_t{bytes[0]} | char32_t{bytes[1]} << 8 |
+				                char32_t{bytes[2]} << 16 |
+				                char32_t{bytes[3]} << 24;
+				auto const be = char32_t{bytes[3]} | char32_t{bytes[2]} << 8 |
+				                char32_t{bytes[1]} << 16 |
+				                char32_t{bytes[0]} << 24;
+				utf32le = utf32le && utf32_unit_valid(le);
+				utf32be = utf32be && utf32_unit_valid(be);
+			}
+
+			void collect(uint8_t const* data, std::size_t length) noexcept {
+				size = length;
+				std::size_t pos = 0;
+				for (; pos + 16 <= length; pos += 16) {
+					auto const block = data + pos;
+					auto const mask = detail::zero_mask16(block);
+					for (unsigned lane = 0; lane < 4; ++lane) {
+						zeros[lane] +=
+						    detail::popcount(mask & (0x1111u << lane));
+					}
+					for (unsigned index = 0; index < 16; ++index) {
+						utf8_state =
+						    detail::utf8_step(utf8_state, block[index]);
+					}
+					for (unsigned index = 0; index < 16; index += 2)
+						pair(block + index);
+					for (unsigned index = 0; index < 16; index += 4)
+						quad(block + index);
+				}
+
+				for (; pos < length; ++pos) {
+					if (!data[pos]) ++zeros[pos % 4];
+					utf8_state = detail::utf8_step(utf8_state, data[pos]);
+				}
+
+				// whole units of the tail; a cut-off one is not an error
+				auto const tail = length & ~std::size_t{15};
+				for (pos = tail; pos + 2 <= length; pos += 2)
+					pair(data + pos);
+				for (pos = tail; pos + 4 <= length; pos += 4)
+					quad(data + pos);
+			}
+
+			double fraction(std::size_t count, std::size_t of) const noexcept {
+				return of ? static_cast<double>(count) / static_cast<double>(of)
+				          : 0.0;
+			}
+
+			/*
+			 * Text is mostly made of characters with zero high bytes: the
+			 * more zeros sit in the high bytes (and the fewer in the low
+			 * ones), the better the wide encodings fit. A valid UTF-32 is
+			 * rare by chance, a valid UTF-16 is not.
+			 */
+			double score(encoding enc) const noexcept {
+				auto const even = zeros[0] + zeros[2];
+				auto const odd = zeros[1] + zeros[3];
+				auto const pairs = size / 2;
+				auto const quads = size / 4;
+				switch (enc) {
+					case encoding::utf8:
+						if (utf8_state == detail::utf8_reject) return 0;
+						return 1.0 - fraction(even + odd, size);
+					case encoding::utf16le:
+						if (!utf16le.valid || !pairs) return 0;
+						return std::clamp(
+						    0.5 + 0.5 * fraction(odd, pairs) -
+						        0.5 * fraction(even, pairs),
+						    0.0, 1.0);
+					case encoding::utf16be:
+						if (!utf16be.valid || !pairs) return 0;
+						return std::clamp(
+						    0.5 + 0.5 * fraction(even, pairs) -
+						        0.5 * fraction(odd, pairs),
+						    0.0, 1.0);
+					case encoding::utf32le:
+						if (!utf32le || !quads) return 0;
+						return 0.8 + 0.2 * fraction(zeros[2], quads);
+					case encoding::utf32be:
+						if (!utf32be || !quads) return 0;
+						return 0.8 + 0.2 * fraction(zeros[1], quads);
+				}
+				return 0;
+			}
+		};
+
+		bool fits(statistics const& stats, encoding enc) {
+			return stats.score(enc) > 0;
+		}
+	}  // namespace
+
+	detect_result detect(std::byte const* data, std::size_t size) {
+		auto const bytes = reinterpret_cast<uint8_t const*>(data);
+		auto const text =
+		    std::string_view{reinterpret_cast<char const*>(data), size};
+
+		for (auto const& bom : boms) {
+			if (text.substr(0, bom.bytes.size()) != bom.bytes) continue;
+			statistics stats{};
+			stats.collect(bytes + bom.bytes.size(), size - bom.bytes.size());
+			auto const confidence =
+			    stats.size == 0 || fits(stats, bom.enc) ? 1.0 : 0.5;
+			return {bom.enc, confidence, bom.bytes.size()};
+		}
+
+		statistics stats{};
+		stats.collect(bytes, size);
+		if (!size) return {};
+
+		detect_result result{};
+		for (auto const enc : {encoding::utf8, encoding::utf16le,
+		                       encoding::utf16be, encoding::utf32le,
+		                       encoding::utf32be}) {
+			auto const score = stats.score(enc);
+			if (score > result.confidence) {
+				result.guess = enc;
+				result.confidence = score;
+			}
+		}
+		return result;
+	}
+}  // namespace utf
@@ -0,0 +1,170 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <utf/utf.hpp>
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+#ifdef UTF_SIMD_SSE2
+		inline __m128i splat(std::uint8_t unit) noexcept {
+			return _mm_set1_epi8(static_cast<char>(unit));
+		}
+
+		inline __m128i splat(char16_t unit) noexcept {
+			return _mm_set1_epi16(static_cast<short>(unit));
+		}
+
+		inline std::uint32_t candidates(std::uint8_t const* first_units,
+		                                std::uint8_t const* last_units,
+		                                __m128i first,
+		                                __m128i last) noexcept {
+			using namespace detail;
+			return movemask8(
+			    _mm_and_si128(_mm_cmpeq_epi8(load(first_units), first),
+			                  _mm_cmpeq_epi8(load(last_units), last)));
+		}
+
+		inline std::uint32_t candidates(char16_t const* first_units,
+		                                char16_t const* last_units,
+		                                __m128i first,
+		                                __m128i last) noexcept {
+			using namespace detail;
+			return movemask16(
+			    _mm_and_si128(_mm_cmpeq_epi16(load(first_units), first),
+			                  _mm_cmpeq_epi16(load(last_units), last)));
+		}
+#endif
+
+		template <typename Unit>
+		inline bool tail_matches(Unit const* candidate,
+		                         Unit const* needle,
+		                         std::size_t length) noexcept {
+			return !length ||
+			       std::memcmp(candidate, needle, length * sizeof(Unit)) == 0;
+		}
+
+		/*
+		 * Generic first/last unit filter: a position is only compared in
+		 * full, if both the first and the last unit of the needle are found
+		 * at their respective places. With a well-formed needle, no match
+		 * may start inside a multi-unit sequence of a well-formed haystack,
+		 * so there is no need to look back for the sequence boundary.
+		 */
+		template <typename Unit>
+		std::size_t find_units(Unit const* haystack,
+		                       std::size_t haystack_length,
+		                       Unit const* needle,
+		                       std::size_t needle_length) noexcept {
+			if (!needle_length) return 0;
+			if (needle_length > haystack_length) return npos;
+
+			auto const last_start = haystack_length - needle_length;
+			auto const last_offset = needle_length - 1;
+			std::size_t index = 0;
+
+#ifdef UTF_SIMD_SSE2
+			static constexpr std::size_t lanes = 16 / sizeof(Unit);
+			auto const first = splat(needle[0]);
+			auto const last = splat(needle[last_offset]);
+			for (; index + lanes <= last_start + 1; index += lanes) {
+				auto mask = candidates(haystack + index,
+				                       haystack + index + last_offset, first,
+				                       last);
+				while (mask) {
+					auto const pos = index + detail::ctz(mask);
+					if (tail_matches(haystack + pos + 1, needle + 1,
+					                 last_offset))
+						return pos;
+					mask &= mask - 1;
+				}
+			}
+#endif
+
+			for (; index <= last_start; ++index) {
+				if (haystack[index] == needle[0] &&
+				    haystack[index + last_offset] == needle[last_offset] &&
+				    tail_matches(haystack + index + 1, needle + 1, last_offset))
+					return index;
+			}
+
+			return npos;
+		}
+
+		template <typename Unit>
+		find_result find_impl(Unit const* haystack,
+		                      std::size_t haystack_length,
+		                      Unit const* needle,
+		                      std::size_t needle_length) noexcept {
+			auto const pos =
+			    find_units(haystack, haystack_length, needle, needle_length);
+			if (pos == npos) return {};
+			return {pos, detail::count_code_points(haystack, pos)};
+		}
+
+		template <typename Char>
+		inline std::uint8_t const* bytes(
+		    std::basic_string_view<Char> view) noexcept {
+			return reinterpret_cast<std::uint8_t const*>(view.data());
+		}
+	}  // namespace
+
+	find_result find(std::string_view haystack, char32_t needle) {
+		if (!detail::is_scalar_value(needle)) return {};
+		auto const encoded = as_str8(std::u32string_view{&needle, 1});
+		return find_impl(bytes(haystack), haystack.size(), bytes<char>(encoded),
+		                 encoded.size());
+	}
+
+	find_result find(std::string_view haystack, std::string_view needle) {
+		if (!is_valid(needle)) return {};
+		return find_impl(bytes(haystack), haystack.size(), bytes(needle),
+		                 needle.size());
+	}
+
+	find_result find(std::u16string_view haystack, char32_t needle) {
+		if (!detail::is_scalar_value(needle)) return {};
+		auto const encoded = as_u16(std::u32string_view{&needle, 1});
+		return find_impl(haystack.data(), haystack.size(), encoded.data(),
+		                 encoded.size());
+	}
+
+	find_result find(std::u16string_view haystack,
+	                 std::u16string_view needle) {
+		// an ill-formed needle, e.g. one starting with a lone low
+		// surrogate, could match in the middle of a surrogate pair
+		if (!is_valid(needle)) return {};
+		return find_impl(haystack.data(), haystack.size(), needle.data(),
+		                 needle.size());
+	}
+
+	find_result find(std::u32string_view haystack, char32_t needle) {
+		if (!detail::is_scalar_value(needle)) return {};
+		auto const pos = haystack.find(needle);
+		if (pos == std::u32string_view::npos) return {};
+		return {pos, pos};
+	}
+
+	find_result find(std::u32string_view haystack,
+	                 std::u32string_view needle) {
+		if (!is_valid(needle)) return {};
+		auto const pos = haystack.find(needle);
+		if (pos == std::u32string_view::npos) return {};
+		return {pos, pos};
+	}
+
+#ifdef __cpp_lib_char8_t
+	find_result find(std::u8string_view haystack, char32_t needle) {
+		if (!detail::is_scalar_value(needle)) return {};
+		auto const encoded = as_u8(std::u32string_view{&needle, 1});
+		return find_impl(bytes(haystack), haystack.size(),
+		                 bytes<char8_t>(encoded), encoded.size());
+	}
+
+	find_result find(std::u8string_view haystack, std::u8string_view needle) {
+		if (!is_valid(needle)) return {};
+		return find_impl(bytes(haystack), haystack.size(), bytes(needle),
+		                 needle.size());
+	}
+#endif  // __cpp_lib_char8_t
+}  // namespace utf
@@ -0,0 +1,882 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utf/graphemes.hpp>
+#include "codec.hpp"
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		// Grapheme_Cluster_Break, with Extended_Pictographic (all of which
+		// is Other) as one more value
+		enum class gcb : std::uint8_t {
+			other,
+			cr,
+			lf,
+			control,
+			extend,
+			zwj,
+			regional_indicator,
+			prepend,
+			spacing_mark,
+			l,
+			v,
+			t,
+			lv,
+			lvt,
+			extended_pictographic,
+		};
+
+		struct property_run {
+			char32_t first;
+			gcb value;
+		};
+
+		/*
+		 * Unicode 15.0, as the first code point of every run of the same
+		 * value. Hangul syllables alternate between LV and LVT, so they
+		 * are told apart by their position instead of being listed.
+		 */
+		constexpr property_run runs[] = {
+		    {0x0000, gcb::control}, {0x000A, gcb::lf}, {0x000B, gcb::control},
+		    {0x000D, gcb::cr}, {0x000E, gcb::control}, {0x0020, gcb::other},
+		    {0x007F, gcb::control}, {0x00A0, gcb::other},
+		    {0x00A9, gcb::extended_pictographic}, {0x00AA, gcb::other},
+		    {0x00AD, gcb::control}, {0x00AE, gcb::extended_pictographic},
+		    {0x00AF, gcb::other}, {0x0300, gcb::extend}, {0x0370, gcb::other},
+		    {0x0483, gcb::extend}, {0x048A, gcb::other}, {0x0591, gcb::extend},
+		    {0x05BE, gcb::other}, {0x05BF, gcb::extend}, {0x05C0, gcb::other},
+		    {0x05C1, gcb::extend}, {0x05C3, gcb::other}, {0x05C4, gcb::extend},
+		    {0x05C6, gcb::other}, {0x05C7, gcb::extend}, {0x05C8, gcb::other},
+		    {0x0600, gcb::prepend}, {0x0606, gcb::other}, {0x0610, gcb::extend},
+		    {0x061B, gcb::other}, {0x061C, gcb::control}, {0x061D, gcb::other},
+		    {0x064B, gcb::extend}, {0x0660, gcb::other}, {0x0670, gcb::extend},
+		    {0x0671, gcb::other}, {0x06D6, gcb::extend}, {0x06DD, gcb::prepend},
+		    {0x06DE, gcb::other}, {0x06DF, gcb::extend}, {0x06E5, gcb::other},
+		    {0x06E7, gcb::extend}, {0x06E9, gcb::other}, {0x06EA, gcb::extend},
+		    {0x06EE, gcb::other}, {0x070F, gcb::prepend}, {0x0710, gcb::other},
+		    {0x0711, gcb::extend}, {0x0712, gcb::other}, {0x0730, gcb::extend},
+		    {0x074B, gcb::other}, {0x07A6, gcb::extend}, {0x07B1, gcb::other},
+		    {0x07EB, gcb::extend}, {0x07F4, gcb::other}, {0x07FD, gcb::extend},
+		    {0x07FE, gcb::other}, {0x0816, gcb::extend}, {0x081A, gcb::other},
+		    {0x081B, gcb::extend}, {0x0824, gcb::other}, {0x0825, gcb::extend},
+		    {0x0828, gcb::other}, {0x0829, gcb::extend}, {0x082E, gcb::other},
+		    {0x0859, gcb::extend}, {0x085C, gcb::other}, {0x0890, gcb::prepend},
+		    {0x0892, gcb::other}, {0x0898, gcb::extend}, {0x08A0, gcb::other},
+		    {0x08CA, gcb::extend}, {0x08E2, gcb::prepend},
+		    {0x08E3, gcb::extend}, {0x0903, gcb::spacing_mark},
+		    {0x0904, gcb::other}, {0x093A, gcb::extend},
+		    {0x093B, gcb::spacing_mark}, {0x093C, gcb::extend},
+		    {0x093D, gcb::other}, {0x093E, gcb::spacing_mark},
+		    {0x0941, gcb::extend}, {0x0949, gcb::spacing_mark},
+		    {0x094D, gcb::extend}, {0x094E, gcb::spacing_mark},
+		    {0x0950, gcb::other}, {0x0951, gcb::extend}, {0x0958, gcb::other},
+		    {0x0962, gcb::extend}, {0x0964, gcb::other}, {0x0981, gcb::extend},
+		    {0x0982, gcb::spacing_mark}, {0x0984, gcb::other},
+		    {0x09BC, gcb::extend}, {0x09BD, gcb::other}, {0x09BE, gcb::extend},
+		    {0x09BF, gcb::spacing_mark}, {0x09C1, gcb::extend},
+		    {0x09C5, gcb::other}, {0x09C7, gcb::spacing_mark},
+		    {0x09C9, gcb::other}, {0x09CB, gcb::spacing_mark},
+		    {0x09CD, gcb::extend}, {0x09CE, gcb::other}, {0x09D7, gcb::extend},
+		    {0x09D8, gcb::other}, {0x09E2, gcb::extend}, {0x09E4, gcb::other},
+		    {0x09FE, gcb::extend}, {0x09FF, gcb::other}, {0x0A01, gcb::extend},
+		    {0x0A03, gcb::spacing_mark}, {0x0A04, gcb::other},
+		    {0x0A3C, gcb::extend}, {0x0A3D, gcb::other},
+		    {0x0A3E, gcb::spacing_mark}, {0x0A41, gcb::extend},
+		    {0x0A43, gcb::other}, {0x0A47, gcb::extend}, {0x0A49, gcb::other},
+		    {0x0A4B, gcb::extend}, {0x0A4E, gcb::other}, {0x0A51, gcb::extend},
+		    {0x0A52, gcb::other}, {0x0A70, gcb::extend}, {0x0A72, gcb::other},
+		    {0x0A75, gcb::extend}, {0x0A76, gcb::other}, {0x0A81, gcb::extend},
+		    {0x0A83, gcb::spacing_mark}, {0x0A84, gcb::other},
+		    {0x0ABC, gcb::extend}, {0x0ABD, gcb::other},
+		    {0x0ABE, gcb::spacing_mark}, {0x0AC1, gcb::extend},
+		    {0x0AC6, gcb::other}, {0x0AC7, gcb::extend},
+		    {0x0AC9, gcb::spacing_mark}, {0x0ACA, gcb::other},
+		    {0x0ACB, gcb::spacing_mark}, {0x0ACD, gcb::extend},
+		    {0x0ACE, gcb::other}, {0x0AE2, gcb::extend}, {0x0AE4, gcb::other},
+		    {0x0AFA, gcb::extend}, {0x0B00, gcb::other}, {0x0B01, gcb::extend},
+		    {0x0B02, gcb::spacing_mark}, {0x0B04, gcb::other},
+		    {0x0B3C, gcb::extend}, {0x0B3D, gcb::other}, {0x0B3E, gcb::extend},
+		    {0x0B40, gcb::spacing_mark}, {0x0B41, gcb::extend},
+		    {0x0B45, gcb::other}, {0x0B47, gcb::spacing_mark},
+		    {0x0B49, gcb::other}, {0x0B4B, gcb::spacing_mark},
+		    {0x0B4D, gcb::extend}, {0x0B4E, gcb::other}, {0x0B55, gcb::extend},
+		    {0x0B58, gcb::other}, {0x0B62, gcb::extend}, {0x0B64, gcb::other},
+		    {0x0B82, gcb::extend}, {0x0B83, gcb::other}, {0x0BBE, gcb::extend},
+		    {0x0BBF, gcb::spacing_mark}, {0x0BC0, gcb::extend},
+		    {0x0BC1, gcb::spacing_mark}, {0x0BC3, gcb::other},
+		    {0x0BC6, gcb::spacing_mark}, {0x0BC9, gcb::other},
+		    {0x0BCA, gcb::spacing_mark}, {0x0BCD, gcb::extend},
+		    {0x0BCE, gcb::other}, {0x0BD7, gcb::extend}, {0x0BD8, gcb::other},
+		    {0x0C00, gcb::extend}, {0x0C01, gcb::spacing_mark},
+		    {0x0C04, gcb::extend}, {0x0C05, gcb::other}, {0x0C3C, gcb::extend},
+		    {0x0C3D, gcb::other}, {0x0C3E, gcb::extend},
+		    {0x0C41, gcb::spacing_mark}, {0x0C45, gcb::other},
+		    {0x0C46, gcb::extend}, {0x0C49, gcb::other}, {0x0C4A, gcb::extend},
+		    {0x0C4E, gcb::other}, {0x0C55, gcb::extend}, {0x0C57, gcb::other},
+		    {0x0C62, gcb::extend}, {0x0C64, gcb::other}, {0x0C81, gcb::extend},
+		    {0x0C82, gcb::spacing_mark}, {0x0C84, gcb::other},
+		    {0x0CBC, gcb::extend}, {0x0CBD, gcb::other},
+		    {0x0CBE, gcb::spacing_mark}, {0x0CBF, gcb::extend},
+		    {0x0CC0, gcb::spacing_mark}, {0x0CC2, gcb::extend},
+		    {0x0CC3, gcb::spacing_mark}, {0x0CC5, gcb::other},
+		    {0x0CC6, gcb::extend}, {0x0CC7, gcb::spacing_mark},
+		    {0x0CC9, gcb::other}, {0x0CCA, gcb::spacing_mark},
+		    {0x0CCC, gcb::extend}, {0x0CCE, gcb::other}, {0x0CD5, gcb::extend},
+		    {0x0CD7, gcb::other}, {0x0CE2, gcb::extend}, {0x0CE4, gcb::other},
+		    {0x0CF3, gcb::spacing_mark}, {0x0CF4, gcb::other},
+		    {0x0D00, gcb::extend}, {0x0D02, gcb::spacing_mark},
+		    {0x0D04, gcb::other}, {0x0D3B, gcb::extend}, {0x0D3D, gcb::other},
+		    {0x0D3E, gcb::extend}, {0x0D3F, gcb::spacing_mark},
+		    {0x0D41, gcb::extend}, {0x0D45, gcb::other},
+		    {0x0D46, gcb::spacing_mark}, {0x0D49, gcb::other},
+		    {0x0D4A, gcb::spacing_mark}, {0x0D4D, gcb::extend},
+		    {0x0D4E, gcb::prepend}, {0x0D4F, gcb::other}, {0x0D57, gcb::extend},
+		    {0x0D58, gcb::other}, {0x0D62, gcb::extend}, {0x0D64, gcb::other},
+		    {0x0D81, gcb::extend}, {0x0D82, gcb::spacing_mark},
+		    {0x0D84, gcb::other}, {0x0DCA, gcb::extend}, {0x0DCB, gcb::other},
+		    {0x0DCF, gcb::extend}, {0x0DD0, gcb::spacing_mark},
+		    {0x0DD2, gcb::extend}, {0x0DD5, gcb::other}, {0x0DD6, gcb::extend},
+		    {0x0DD7, gcb::other}, {0x0DD8, gcb::spacing_mark},
+		    {0x0DDF, gcb::extend}, {0x0DE0, gcb::other},
+		    {0x0DF2, gcb::spacing_mark}, {0x0DF4, gcb::other},
+		    {0x0E31, gcb::extend}, {0x0E32, gcb::other},
+		    {0x0E33, gcb::spacing_mark}, {0x0E34, gcb::extend},
+		    {0x0E3B, gcb::other}, {0x0E47, gcb::extend}, {0x0E4F, gcb::other},
+		    {0x0EB1, gcb::extend}, {0x0EB2, gcb::other},
+		    {0x0EB3, gcb::spacing_mark}, {0x0EB4, gcb::extend},
+		    {0x0EBD, gcb::other}, {0x0EC8, gcb::extend}, {0x0ECF, gcb::other},
+		    {0x0F18, gcb::extend}, {0x0F1A, gcb::other}, {0x0F35, gcb::extend},
+		    {0x0F36, gcb::other}, {0x0F37, gcb::extend}, {0x0F38, gcb::other},
+		    {0x0F39, gcb::extend}, {0x0F3A, gcb::other},
+		    {0x0F3E, gcb::spacing_mark}, {0x0F40, gcb::other},
+		    {0x0F71, gcb::extend}, {0x0F7F, gcb::spacing_mark},
+		    {0x0F80, gcb::extend}, {0x0F85, gcb::other}, {0x0F86, gcb::extend},
+		    {0x0F88, gcb::other}, {0x0F8D, gcb::extend}, {0x0F98, gcb::other},
+		    {0x0F99, gcb::extend}, {0x0FBD, gcb::other}, {0x0FC6, gcb::extend},
+		    {0x0FC7, gcb::other}, {0x102D, gcb::extend},
+		    {0x1031, gcb::spacing_mark}, {0x1032, gcb::extend},
+		    {0x1038, gcb::other}, {0x1039, gcb::extend},
+		    {0x103B, gcb::spacing_mark}, {0x103D, gcb::extend},
+		    {0x103F, gcb::other}, {0x1056, gcb::spacing_mark},
+		    {0x1058, gcb::extend}, {0x105A, gcb::other}, {0x105E, gcb::extend},
+		    {0x1061, gcb::other}, {0x1071, gcb::extend}, {0x1075, gcb::other},
+		    {0x1082, gcb::extend}, {0x1083, gcb::other},
+		    {0x1084, gcb::spacing_mark}, {0x1085, gcb::extend},
+		    {0x1087, gcb::other}, {0x108D, gcb::extend}, {0x108E, gcb::other},
+		    {0x109D, gcb::extend}, {0x109E, gcb::other}, {0x1100, gcb::l},
+		    {0x1160, gcb::v}, {0x11A8, gcb::t}, {0x1200, gcb::other},
+		    {0x135D, gcb::extend}, {0x1360, gcb::other}, {0x1712, gcb::extend},
+		    {0x1715, gcb::spacing_mark}, {0x1716, gcb::other},
+		    {0x1732, gcb::extend}, {0x1734, gcb::spacing_mark},
+		    {0x1735, gcb::other}, {0x1752, gcb::extend}, {0x1754, gcb::other},
+		    {0x1772, gcb::extend}, {0x1774, gcb::other}, {0x17B4, gcb::extend},
+		    {0x17B6, gcb::spacing_mark}, {0x17B7, gcb::extend},
+		    {0x17BE, gcb::spacing_mark}, {0x17C6, gcb::extend},
+		    {0x17C7, gcb::spacing_mark}, {0x17C9, gcb::extend},
+		    {0x17D4, gcb::other}, {0x17DD, gcb::extend}, {0x17DE, gcb::other},
+		    {0x180B, gcb::extend}, {0x180E, gcb::control},
+		    {0x180F, gcb::extend}, {0x1810, gcb::other}, {0x1885, gcb::extend},
+		    {0x1887, gcb::other}, {0x18A9, gcb::extend}, {0x18AA, gcb::other},
+		    {0x1920, gcb::extend}, {0x1923, gcb::spacing_mark},
+		    {0x1927, gcb::extend}, {0x1929, gcb::spacing_mark},
+		    {0x192C, gcb::other}, {0x1930, gcb::spacing_mark},
+		    {0x1932, gcb::extend}, {0x1933, gcb::spacing_mark},
+		    {0x1939, gcb::extend}, {0x193C, gcb::other}, {0x1A17, gcb::extend},
+		    {0x1A19, gcb::spacing_mark}, {0x1A1B, gcb::extend},
+		    {0x1A1C, gcb::other}, {0x1A55, gcb::spacing_mark},
+		    {0x1A56, gcb::extend}, {0x1A57, gcb::spacing_mark},
+		    {0x1A58, gcb::extend}, {0x1A5F, gcb::other}, {0x1A60, gcb::extend},
+		    {0x1A61, gcb::other}, {0x1A62, gcb::extend}, {0x1A63, gcb::other},
+		    {0x1A65, gcb::extend}, {0x1A6D, gcb::spacing_mark},
+		    {0x1A73, gcb::extend}, {0x1A7D, gcb::other}, {0x1A7F, gcb::extend},
+		    {0x1A80, gcb::other}, {0x1AB0, gcb::extend}, {0x1ACF, gcb::other},
+		    {0x1B00, gcb::extend}, {0x1B04, gcb::spacing_mark},
+		    {0x1B05, gcb::other}, {0x1B34, gcb::extend},
+		    {0x1B3B, gcb::spacing_mark}, {0x1B3C, gcb::extend},
+		    {0x1B3D, gcb::spacing_mark}, {0x1B42, gcb::extend},
+		    {0x1B43, gcb::spacing_mark}, {0x1B45, gcb::other},
+		    {0x1B6B, gcb::extend}, {0x1B74, gcb::other}, {0x1B80, gcb::extend},
+		    {0x1B82, gcb::spacing_mark}, {0x1B83, gcb::other},
+		    {0x1BA1, gcb::spacing_mark}, {0x1BA2, gcb::extend},
+		    {0x1BA6, gcb::spacing_mark}, {0x1BA8, gcb::extend},
+		    {0x1BAA, gcb::spacing_mark}, {0x1BAB, gcb::extend},
+		    {0x1BAE, gcb::other}, {0x1BE6, gcb::extend},
+		    {0x1BE7, gcb::spacing_mark}, {0x1BE8, gcb::extend},
+		    {0x1BEA, gcb::spacing_mark}, {0x1BED, gcb::extend},
+		    {0x1BEE, gcb::spacing_mark}, {0x1BEF, gcb::extend},
+		    {0x1BF2, gcb::spacing_mark}, {0x1BF4, gcb::other},
+		    {0x1C24, gcb::spacing_mark}, {0x1C2C, gcb::extend},
+		    {0x1C34, gcb::spacing_mark}, {0x1C36, gcb::extend},
+		    {0x1C38, gcb::other}, {0x1CD0, gcb::extend}, {0x1CD3, gcb::other},
+		    {0x1CD4, gcb::extend}, {0x1CE1, gcb::spacing_mark},
+		    {0x1CE2, gcb::extend}, {0x1CE9, gcb::other}, {0x1CED, gcb::extend},
+		    {0x1CEE, gcb::other}, {0x1CF4, gcb::extend}, {0x1CF5, gcb::other},
+		    {0x1CF7, gcb::spacing_mark}, {0x1CF8, gcb::extend},
+		    {0x1CFA, gcb::other}, {0x1DC0, gcb::extend}, {0x1E00, gcb::other},
+		    {0x200B, gcb::control}, {0x200C, gcb::extend}, {0x200D, gcb::zwj},
+		    {0x200E, gcb::control}, {0x2010, gcb::other},
+		    {0x2028, gcb::control}, {0x202F, gcb::other},
+		    {0x203C, gcb::extended_pictographic}, {0x203D, gcb::other},
+		    {0x2049, gcb::extended_pictographic}, {0x204A, gcb::other},
+		    {0x2060, gcb::control}, {0x2070, gcb::other}, {0x20D0, gcb::extend},
+		    {0x20F1, gcb::other}, {0x2122, gcb::extended_pictographic},
+		    {0x2123, gcb::other}, {0x2139, gcb::extended_pictographic},
+		    {0x213A, gcb::other}, {0x2194, gcb::extended_pictographic},
+		    {0x219A, gcb::other}, {0x21A9, gcb::extended_pictographic},
+		    {0x21AB, gcb::other}, {0x231A, gcb::extended_pictographic},
+		    {0x231C, gcb::other}, {0x2328, gcb::extended_pictographic},
+		    {0x2329, gcb::other}, {0x2388, gcb::extended_pictographic},
+		    {0x2389, gcb::other}, {0x23CF, gcb::extended_pictographic},
+		    {0x23D0, gcb::other}, {0x23E9, gcb::extended_pictographic},
+		    {0x23F4, gcb::other}, {0x23F8, gcb::extended_pictographic},
+		    {0x23FB, gcb::other}, {0x24C2, gcb::extended_pictographic},
+		    {0x24C3, gcb::other}, {0x25AA, gcb::extended_pictographic},
+		    {0x25AC, gcb::other}, {0x25B6, gcb::extended_pictographic},
+		    {0x25B7, gcb::other}, {0x25C0, gcb::extended_pictographic},
+		    {0x25C1, gcb::other}, {0x25FB, gcb::extended_pictographic},
+		    {0x25FF, gcb::other}, {0x2600, gcb::extended_pictographic},
+		    {0x2606, gcb::other}, {0x2607, gcb::extended_pictographic},
+		    {0x2613, gcb::other}, {0x2614, gcb::extended_pictographic},
+		    {0x2686, gcb::other}, {0x2690, gcb::extended_pictographic},
+		    {0x2706, gcb::other}, {0x2708, gcb::extended_pictographic},
+		    {0x2713, gcb::other}, {0x2714, gcb::extended_pictographic},
+		    {0x2715, gcb::other}, {0x2716, gcb::extended_pictographic},
+		    {0x2717, gcb::other}, {0x271D, gcb::extended_pictographic},
+		    {0x271E, gcb::other}, {0x2721, gcb::extended_pictographic},
+		    {0x2722, gcb::other}, {0x2728, gcb::extended_pictographic},
+		    {0x2729, gcb::other}, {0x2733, gcb::extended_pictographic},
+		    {0x2735, gcb::other}, {0x2744, gcb::extended_pictographic},
+		    {0x2745, gcb::other}, {0x2747, gcb::extended_pictographic},
+		    {0x2748, gcb::other}, {0x274C, gcb::extended_pictographic},
+		    {0x274D, gcb::other}, {0x274E, gcb::extended_pictographic},
+		    {0x274F, gcb::other}, {0x2753, gcb::extended_pictographic},
+		    {0x2756, gcb::other}, {0x2757, gcb::extended_pictographic},
+		    {0x2758, gcb::other}, {0x2763, gcb::extended_pictographic},
+		    {0x2768, gcb::other}, {0x2795, gcb::extended_pictographic},
+		    {0x2798, gcb::other}, {0x27A1, gcb::extended_pictographic},
+		    {0x27A2, gcb::other}, {0x27B0, gcb::extended_pictographic},
+		    {0x27B1, gcb::other}, {0x27BF, gcb::extended_pictographic},
+		    {0x27C0, gcb::other}, {0x2934, gcb::extended_pictographic},
+		    {0x2936, gcb::other}, {0x2B05, gcb::extended_pictographic},
+		    {0x2B08, gcb::other}, {0x2B1B, gcb::extended_pictographic},
+		    {0x2B1D, gcb::other}, {0x2B50, gcb::extended_pictographic},
+		    {0x2B51, gcb::other}, {0x2B55, gcb::extended_pictographic},
+		    {0x2B56, gcb::other}, {0x2CEF, gcb::extend}, {0x2CF2, gcb::other},
+		    {0x2D7F, gcb::extend}, {0x2D80, gcb::other}, {0x2DE0, gcb::extend},
+		    {0x2E00, gcb::other}, {0x302A, gcb::extend},
+		    {0x3030, gcb::extended_pictographic}, {0x3031, gcb::other},
+		    {0x303D, gcb::extended_pictographic}, {0x303E, gcb::other},
+		    {0x3099, gcb::extend}, {0x309B, gcb::other},
+		    {0x3297, gcb::extended_pictographic}, {0x3298, gcb::other},
+		    {0x3299, gcb::extended_pictographic}, {0x329A, gcb::other},
+		    {0xA66F, gcb::extend}, {0xA673, gcb::other}, {0xA674, gcb::extend},
+		    {0xA67E, gcb::other}, {0xA69E, gcb::extend}, {0xA6A0, gcb::other},
+		    {0xA6F0, gcb::extend}, {0xA6F2, gcb::other}, {0xA802, gcb::extend},
+		    {0xA803, gcb::other}, {0xA806, gcb::extend}, {0xA807, gcb::other},
+		    {0xA80B, gcb::extend}, {0xA80C, gcb::other},
+		    {0xA823, gcb::spacing_mark}, {0xA825, gcb::extend},
+		    {0xA827, gcb::spacing_mark}, {0xA828, gcb::other},
+		    {0xA82C, gcb::extend}, {0xA82D, gcb::other},
+		    {0xA880, gcb::spacing_mark}, {0xA882, gcb::other},
+		    {0xA8B4, gcb::spacing_mark}, {0xA8C4, gcb::extend},
+		    {0xA8C6, gcb::other}, {0xA8E0, gcb::extend}, {0xA8F2, gcb::other},
+		    {0xA8FF, gcb::extend}, {0xA900, gcb::other}, {0xA926, gcb::extend},
+		    {0xA92E, gcb::other}, {0xA947, gcb::extend},
+		    {0xA952, gcb::spacing_mark}, {0xA954, gcb::other}, {0xA960, gcb::l},
+		    {0xA97D, gcb::other}, {0xA980, gcb::extend},
+		    {0xA983, gcb::spacing_mark}, {0xA984, gcb::other},
+		    {0xA9B3, gcb::extend}, {0xA9B4, gcb::spacing_mark},
+		    {0xA9B6, gcb::extend}, {0xA9BA, gcb::spacing_mark},
+		    {0xA9BC, gcb::extend}, {0xA9BE, gcb::spacing_mark},
+		    {0xA9C1, gcb::other}, {0xA9E5, gcb::extend}, {0xA9E6, gcb::other},
+		    {0xAA29, gcb::extend}, {0xAA2F, gcb::spacing_mark},
+		    {0xAA31, gcb::extend}, {0xAA33, gcb::spacing_mark},
+		    {0xAA35, gcb::extend}, {0xAA37, gcb::other}, {0xAA43, gcb::extend},
+		    {0xAA44, gcb::other}, {0xAA4C, gcb::extend},
+		    {0xAA4D, gcb::spacing_mark}, {0xAA4E, gcb::other},
+		    {0xAA7C, gcb::extend}, {0xAA7D, gcb::other}, {0xAAB0, gcb::extend},
+		    {0xAAB1, gcb::other}, {0xAAB2, gcb::extend}, {0xAAB5, gcb::other},
+		    {0xAAB7, gcb::extend}, {0xAAB9, gcb::other}, {0xAABE, gcb::extend},
+		    {0xAAC0, gcb::other}, {0xAAC1, gcb::extend}, {0xAAC2, gcb::other},
+		    {0xAAEB, gcb::spacing_mark}, {0xAAEC, gcb::extend},
+		    {0xAAEE, gcb::spacing_mark}, {0xAAF0, gcb::other},
+		    {0xAAF5, gcb::spacing_mark}, {0xAAF6, gcb::extend},
+		    {0xAAF7, gcb::other}, {0xABE3, gcb::spacing_mark},
+		    {0xABE5, gcb::extend}, {0xABE6, gcb::spacing_mark},
+		    {0xABE8, gcb::extend}, {0xABE9, gcb::spacing_mark},
+		    {0xABEB, gcb::other}, {0xABEC, gcb::spacing_mark},
+		    {0xABED, gcb::extend}, {0xABEE, gcb::other}, {0xAC00, gcb::lv},
+		    {0xD7A4, gcb::other}, {0xD7B0, gcb::v}, {0xD7C7, gcb::other},
+		    {0xD7CB, gcb::t}, {0xD7FC, gcb::other}, {0xFB1E, gcb::extend},
+		    {0xFB1F, gcb::other}, {0xFE00, gcb::extend}, {0xFE10, gcb::other},
+		    {0xFE20, gcb::extend}, {0xFE30, gcb::other}, {0xFEFF, gcb::control},
+		    {0xFF00, gcb::other}, {0xFF9E, gcb::extend}, {0xFFA0, gcb::other},
+		    {0xFFF0, gcb::control}, {0xFFFC, gcb::other},
+		    {0x101FD, gcb::extend}, {0x101FE, gcb::other},
+		    {0x102E0, gcb::extend}, {0x102E1, gcb::other},
+		    {0x10376, gcb::extend}, {0x1037B, gcb::other},
+		    {0x10A01, gcb::extend}, {0x10A04, gcb::other},
+		    {0x10A05, gcb::extend}, {0x10A07, gcb::other},
+		    {0x10A0C, gcb::extend}, {0x10A10, gcb::other},
+		    {0x10A38, gcb::extend}, {0x10A3B, gcb::other},
+		    {0x10A3F, gcb::extend}, {0x10A40, gcb::other},
+		    {0x10AE5, gcb::extend}, {0x10AE7, gcb::other},
+		    {0x10D24, gcb::extend}, {0x10D28, gcb::other},
+		    {0x10EAB, gcb::extend}, {0x10EAD, gcb::other},
+		    {0x10EFD, gcb::extend}, {0x10F00, gcb::other},
+		    {0x10F46, gcb::extend}, {0x10F51, gcb::other},
+		    {0x10F82, gcb::extend}, {0x10F86, gcb::other},
+		    {0x11000, gcb::spacing_mark}, {0x11001, gcb::extend},
+		    {0x11002, gcb::spacing_mark}, {0x11003, gcb::other},
+		    {0x11038, gcb::extend}, {0x11047, gcb::other},
+		    {0x11070, gcb::extend}, {0x11071, gcb::other},
+		    {0x11073, gcb::extend}, {0x11075, gcb::other},
+		    {0x1107F, gcb::extend}, {0x11082, gcb::spacing_mark},
+		    {0x11083, gcb::other}, {0x110B0, gcb::spacing_mark},
+		    {0x110B3, gcb::extend}, {0x110B7, gcb::spacing_mark},
+		    {0x110B9, gcb::extend}, {0x110BB, gcb::other},
+		    {0x110BD, gcb::prepend}, {0x110BE, gcb::other},
+		    {0x110C2, gcb::extend}, {0x110C3, gcb::other},
+		    {0x110CD, gcb::prepend}, {0x110CE, gcb::other},
+		    {0x11100, gcb::extend}, {0x11103, gcb::other},
+		    {0x11127, gcb::extend}, {0x1112C, gcb::spacing_mark},
+		    {0x1112D, gcb::extend}, {0x11135, gcb::other},
+		    {0x11145, gcb::spacing_mark}, {0x11147, gcb::other},
+		    {0x11173, gcb::extend}, {0x11174, gcb::other},
+		    {0x11180, gcb::extend}, {0x11182, gcb::spacing_mark},
+		    {0x11183, gcb::other}, {0x111B3, gcb::spacing_mark},
+		    {0x111B6, gcb::extend}, {0x111BF, gcb::spacing_mark},
+		    {0x111C1, gcb::other}, {0x111C2, gcb::prepend},
+		    {0x111C4, gcb::other}, {0x111C9, gcb::extend},
+		    {0x111CD, gcb::other}, {0x111CE, gcb::spacing_mark},
+		    {0x111CF, gcb::extend}, {0x111D0, gcb::other},
+		    {0x1122C, gcb::spacing_mark}, {0x1122F, gcb::extend},
+		    {0x11232, gcb::spacing_mark}, {0x11234, gcb::extend},
+		    {0x11235, gcb::spacing_mark}, {0x11236, gcb::extend},
+		    {0x11238, gcb::other}, {0x1123E, gcb::extend},
+		    {0x1123F, gcb::other}, {0x11241, gcb::extend},
+		    {0x11242, gcb::other}, {0x112DF, gcb::extend},
+		    {0x112E0, gcb::spacing_mark}, {0x112E3, gcb::extend},
+		    {0x112EB, gcb::other}, {0x11300, gcb::extend},
+		    {0x11302, gcb::spacing_mark}, {0x11304, gcb::other},
+		    {0x1133B, gcb::extend}, {0x1133D, gcb::other},
+		    {0x1133E, gcb::extend}, {0x1133F, gcb::spacing_mark},
+		    {0x11340, gcb::extend}, {0x11341, gcb::spacing_mark},
+		    {0x11345, gcb::other}, {0x11347, gcb::spacing_mark},
+		    {0x11349, gcb::other}, {0x1134B, gcb::spacing_mark},
+		    {0x1134E, gcb::other}, {0x11357, gcb::extend},
+		    {0x11358, gcb::other}, {0x11362, gcb::spacing_mark},
+		    {0x11364, gcb::other}, {0x11366, gcb::extend},
+		    {0x1136D, gcb::other}, {0x11370, gcb::extend},
+		    {0x11375, gcb::other}, {0x11435, gcb::spacing_mark},
+		    {0x11438, gcb::extend}, {0x11440, gcb::spacing_mark},
+		    {0x11442, gcb::extend}, {0x11445, gcb::spacing_mark},
+		    {0x11446, gcb::extend}, {0x11447, gcb::other},
+		    {0x1145E, gcb::extend}, {0x1145F, gcb::other},
+		    {0x114B0, gcb::extend}, {0x114B1, gcb::spacing_mark},
+		    {0x114B3, gcb::extend}, {0x114B9, gcb::spacing_mark},
+		    {0x114BA, gcb::extend}, {0x114BB, gcb::spacing_mark},
+		    {0x114BD, gcb::extend}, {0x114BE, gcb::spacing_mark},
+		    {0x114BF, gcb::extend}, {0x114C1, gcb::spacing_mark},
+		    {0x114C2, gcb::extend}, {0x114C4, gcb::other},
+		    {0x115AF, gcb::extend}, {0x115B0, gcb::spacing_mark},
+		    {0x115B2, gcb::extend}, {0x115B6, gcb::other},
+		    {0x115B8, gcb::spacing_mark}, {0x115BC, gcb::extend},
+		    {0x115BE, gcb::spacing_mark}, {0x115BF, gcb::extend},
+		    {0x115C1, gcb::other}, {0x115DC, gcb::extend},
+		    {0x115DE, gcb::other}, {0x11630, gcb::spacing_mark},
+		    {0x11633, gcb::extend}, {0x1163B, gcb::spacing_mark},
+		    {0x1163D, gcb::extend}, {0x1163E, gcb::spacing_mark},
+		    {0x1163F, gcb::extend}, {0x11641, gcb::other},
+		    {0x116AB, gcb::extend}, {0x116AC, gcb::spacing_mark},
+		    {0x116AD, gcb::extend}, {0x116AE, gcb::spacing_mark},
+		    {0x116B0, gcb::extend}, {0x116B6, gcb::spacing_mark},
+		    {0x116B7, gcb::extend}, {0x116B8, gcb::other},
+		    {0x1171D, gcb::extend}, {0x11720, gcb::other},
+		    {0x11722, gcb::extend}, {0x11726, gcb::spacing_mark},
+		    {0x11727, gcb::extend}, {0x1172C, gcb::other},
+		    {0x1182C, gcb::spacing_mark}, {0x1182F, gcb::extend},
+		    {0x11838, gcb::spacing_mark}, {0x11839, gcb::extend},
+		    {0x1183B, gcb::other}, {0x11930, gcb::extend},
+		    {0x11931, gcb::spacing_mark}, {0x11936, gcb::other},
+		    {0x11937, gcb::spacing_mark}, {0x11939, gcb::other},
+		    {0x1193B, gcb::extend}, {0x1193D, gcb::spacing_mark},
+		    {0x1193E, gcb::extend}, {0x1193F, gcb::prepend},
+		    {0x11940, gcb::spacing_mark}, {0x11941, gcb::prepend},
+		    {0x11942, gcb::spacing_mark}, {0x11943, gcb::extend},
+		    {0x11944, gcb::other}, {0x119D1, gcb::spacing_mark},
+		    {0x119D4, gcb::extend}, {0x119D8, gcb::other},
+		    {0x119DA, gcb::extend}, {0x119DC, gcb::spacing_mark},
+		    {0x119E0, gcb::extend}, {0x119E1, gcb::other},
+		    {0x119E4, gcb::spacing_mark}, {0x119E5, gcb::other},
+		    {0x11A01, gcb::extend}, {0x11A0B, gcb::other},
+		    {0x11A33, gcb::extend}, {0x11A39, gcb::spacing_mark},
+		    {0x11A3A, gcb::prepend}, {0x11A3B, gcb::extend},
+		    {0x11A3F, gcb::other}, {0x11A47, gcb::extend},
+		    {0x11A48, gcb::other}, {0x11A51, gcb::extend},
+		    {0x11A57, gcb::spacing_mark}, {0x11A59, gcb::extend},
+		    {0x11A5C, gcb::other}, {0x11A84, gcb::prepend},
+		    {0x11A8A, gcb::extend}, {0x11A97, gcb::spacing_mark},
+		    {0x11A98, gcb::extend}, {0x11A9A, gcb::other},
+		    {0x11C2F, gcb::spacing_mark}, {0x11C30, gcb::extend},
+		    {0x11C37, gcb::other}, {0x11C38, gcb::extend},
+		    {0x11C3E, gcb::spacing_mark}, {0x11C3F, gcb::extend},
+		    {0x11C40, gcb::other}, {0x11C92, gcb::extend},
+		    {0x11CA8, gcb::other}, {0x11CA9, gcb::spacing_mark},
+		    {0x11CAA, gcb::extend}, {0x11CB1, gcb::spacing_mark},
+		    {0x11CB2, gcb::extend}, {0x11CB4, gcb::spacing_mark},
+		    {0x11CB5, gcb::extend}, {0x11CB7, gcb::other},
+		    {0x11D31, gcb::extend}, {0x11D37, gcb::other},
+		    {0x11D3A, gcb::extend}, {0x11D3B, gcb::other},
+		    {0x11D3C, gcb::extend}, {0x11D3E, gcb::other},
+		    {0x11D3F, gcb::extend}, {0x11D46, gcb::prepend},
+		    {0x11D47, gcb::extend}, {0x11D48, gcb::other},
+		    {0x11D8A, gcb::spacing_mark}, {0x11D8F, gcb::other},
+		    {0x11D90, gcb::extend}, {0x11D92, gcb::other},
+		    {0x11D93, gcb::spacing_mark}, {0x11D95, gcb::extend},
+		    {0x11D96, gcb::spacing_mark}, {0x11D97, gcb::extend},
+		    {0x11D98, gcb::other}, {0x11EF3, gcb::extend},
+		    {0x11EF5, gcb::spacing_mark}, {0x11EF7, gcb::other},
+		    {0x11F00, gcb::extend}, {0x11F02, gcb::prepend},
+		    {0x11F03, gcb::spacing_mark}, {0x11F04, gcb::other},
+		    {0x11F34, gcb::spacing_mark}, {0x11F36, gcb::extend},
+		    {0x11F3B, gcb::other}, {0x11F3E, gcb::spacing_mark},
+		    {0x11F40, gcb::extend}, {0x11F41, gcb::spacing_mark},
+		    {0x11F42, gcb::extend}, {0x11F43, gcb::other},
+		    {0x13430, gcb::control}, {0x13440, gcb::extend},
+		    {0x13441, gcb::other}, {0x13447, gcb::extend},
+		    {0x13456, gcb::other}, {0x16AF0, gcb::extend},
+		    {0x16AF5, gcb::other}, {0x16B30, gcb::extend},
+		    {0x16B37, gcb::other}, {0x16F4F, gcb::extend},
+		    {0x16F50, gcb::other}, {0x16F51, gcb::spacing_mark},
+		    {0x16F88, gcb::other}, {0x16F8F, gcb::extend},
+		    {0x16F93, gcb::other}, {0x16FE4, gcb::extend},
+		    {0x16FE5, gcb::other}, {0x16FF0, gcb::spacing_mark},
+		    {0x16FF2, gcb::other}, {0x1BC9D, gcb::extend},
+		    {0x1BC9F, gcb::other}, {0x1BCA0, gcb::control},
+		    {0x1BCA4, gcb::other}, {0x1CF00, gcb::extend},
+		    {0x1CF2E, gcb::other}, {0x1CF30, gcb::extend},
+		    {0x1CF47, gcb::other}, {0x1D165, gcb::extend},
+		    {0x1D166, gcb::spacing_mark}, {0x1D167, gcb::extend},
+		    {0x1D16A, gcb::other}, {0x1D16D, gcb::spacing_mark},
+		    {0x1D16E, gcb::extend}, {0x1D173, gcb::control},
+		    {0x1D17B, gcb::extend}, {0x1D183, gcb::other},
+		    {0x1D185, gcb::extend}, {0x1D18C, gcb::other},
+		    {0x1D1AA, gcb::extend}, {0x1D1AE, gcb::other},
+		    {0x1D242, gcb::extend}, {0x1D245, gcb::other},
+		    {0x1DA00, gcb::extend}, {0x1DA37, gcb::other},
+		    {0x1DA3B, gcb::extend}, {0x1DA6D, gcb::other},
+		    {0x1DA75, gcb::extend}, {0x1DA76, gcb::other},
+		    {0x1DA84, gcb::extend}, {0x1DA85, gcb::other},
+		    {0x1DA9B, gcb::extend}, {0x1DAA0, gcb::other},
+		    {0x1DAA1, gcb::extend}, {0x1DAB0, gcb::other},
+		    {0x1E000, gcb::extend}, {0x1E007, gcb::other},
+		    {0x1E008, gcb::extend}, {0x1E019, gcb::other},
+		    {0x1E01B, gcb::extend}, {0x1E022, gcb::other},
+		    {0x1E023, gcb::extend}, {0x1E025, gcb::other},
+		    {0x1E026, gcb::extend}, {0x1E02B, gcb::other},
+		    {0x1E08F, gcb::extend}, {0x1E090, gcb::other},
+		    {0x1E130, gcb::extend}, {0x1E137, gcb::other},
+		    {0x1E2AE, gcb::extend}, {0x1E2AF, gcb::other},
+		    {0x1E2EC, gcb::extend}, {0x1E2F0, gcb::other},
+		    {0x1E4EC, gcb::extend}, {0x1E4F0, gcb::other},
+		    {0x1E8D0, gcb::extend}, {0x1E8D7, gcb::other},
+		    {0x1E944, gcb::extend}, {0x1E94B, gcb::other},
+		    {0x1F000, gcb::extended_pictographic}, {0x1F100, gcb::other},
+		    {0x1F10D, gcb::extended_pictographic}, {0x1F110, gcb::other},
+		    {0x1F12F, gcb::extended_pictographic}, {0x1F130, gcb::other},
+		    {0x1F16C, gcb::extended_pictographic}, {0x1F172, gcb::other},
+		    {0x1F17E, gcb::extended_pictographic}, {0x1F180, gcb::other},
+		    {0x1F18E, gcb::extended_pictographic}, {0x1F18F, gcb::other},
+		    {0x1F191, gcb::extended_pictographic}, {0x1F19B, gcb::other},
+		    {0x1F1AD, gcb::extended_pictographic},
+		    {0x1F1E6, gcb::regional_indicator}, {0x1F200, gcb::other},
+		    {0x1F201, gcb::extended_pictographic}, {0x1F210, gcb::other},
+		    {0x1F21A, gcb::extended_pictographic}, {0x1F21B, gcb::other},
+		    {0x1F22F, gcb::extended_pictographic}, {0x1F230, gcb::other},
+		    {0x1F232, gcb::extended_pictographic}, {0x1F23B, gcb::other},
+		    {0x1F23C, gcb::extended_pictographic}, {0x1F240, gcb::other},
+		    {0x1F249, gcb::extended_pictographic}, {0x1F3FB, gcb::extend},
+		    {0x1F400, gcb::extended_pictographic}, {0x1F53E, gcb::other},
+		    {0x1F546, gcb::extended_pictographic}, {0x1F650, gcb::other},
+		    {0x1F680, gcb::extended_pictographic}, {0x1F700, gcb::other},
+		    {0x1F774, gcb::extended_pictographic}, {0x1F780, gcb::other},
+		    {0x1F7D5, gcb::extended_pictographic}, {0x1F800, gcb::other},
+		    {0x1F80C, gcb::extended_pictographic}, {0x1F810, gcb::other},
+		    {0x1F848, gcb::extended_pictographic}, {0x1F850, gcb::other},
+		    {0x1F85A, gcb::extended_pictographic}, {0x1F860, gcb::other},
+		    {0x1F888, gcb::extended_pictographic}, {0x1F890, gcb::other},
+		    {0x1F8AE, gcb::extended_pictographic}, {0x1F900, gcb::other},
+		    {0x1F90C, gcb::extended_pictographic}, {0x1F93B, gcb::other},
+		    {0x1F93C, gcb::extended_pictographic}, {0x1F946, gcb::other},
+		    {0x1F947, gcb::extended_pictographic}, {0x1FB00, gcb::other},
+		    {0x1FC00, gcb::extended_pictographic}, {0x1FFFE, gcb::other},
+		    {0xE0000, gcb::control}, {0xE0020, gcb::extend},
+		    {0xE0080, gcb::control}, {0xE0100, gcb::extend},
+		    {0xE01F0, gcb::control}, {0xE1000, gcb::other},
+		};
+
+		constexpr char32_t hangul_first = 0xAC00;
+		constexpr char32_t hangul_last = 0xD7A3;
+		constexpr char32_t hangul_t_count = 28;
+
+		constexpr unsigned block_shift = 7;
+		constexpr std::size_t block_size = std::size_t{1} << block_shift;
+		constexpr std::size_t block_count = 0x110000 >> block_shift;
+		constexpr std::size_t max_blocks = 160;
+
+		/*
+		 * Two stages: the upper bits of the code point pick one of the
+		 * distinct blocks of 128 values, which are stored two to a byte.
+		 */
+		struct property_table {
+			std::uint8_t block_of[block_count]{};
+			std::uint8_t blocks[max_blocks][block_size / 2]{};
+			bool complete{true};
+		};
+
+		constexpr gcb value_at(char32_t ch, std::size_t& run) {
+			while (run + 1 < std::size(runs) && runs[run + 1].first <= ch)
+				++run;
+			if (ch >= hangul_first && ch <= hangul_last)
+				return (ch - hangul_first) % hangul_t_count ? gcb::lvt
+				                                            : gcb::lv;
+			return runs[run].value;
+		}
+
+		/*
+		 * Most blocks lie inside a single run; those are filled at once and
+		 * shared by value, only the others are built one code point at a
+		 * time and compared with the blocks stored so far.
+		 */
+		constexpr property_table make_table() {
+			property_table table{};
+			std::size_t used = 0;
+			std::size_t run = 0;
+			std::size_t uniform[16]{};
+			for (std::size_t block = 0; block < block_count; ++block) {
+				auto const first = static_cast<char32_t>(block << block_shift);
+				auto const last = static_cast<char32_t>(first + block_size - 1);
+				auto const value = value_at(first, run);
+				auto const single =
+				    (run + 1 == std::size(runs) ||
+				     runs[run + 1].first > last) &&
+				    (last < hangul_first || first > hangul_last);
+
+				auto& shared = uniform[static_cast<std::size_t>(value)];
+				if (single && shared) {
+					table.block_of[block] =
+					    static_cast<std::uint8_t>(shared - 1);
+					continue;
+				}
+
+				std::uint8_t packed[block_size / 2]{};
+				for (std::size_t index = 0; index < block_size; ++index) {
+					auto const ch = static_cast<char32_t>(first + index);
+					auto const at = single ? value : value_at(ch, run);
+					packed[index / 2] |= static_cast<std::uint8_t>(
+					    static_cast<unsigned>(at) << (index % 2 * 4));
+				}
+
+				std::size_t found = 0;
+				for (; found < used; ++found) {
+					std::size_t index = 0;
+					while (index < block_size / 2 &&
+					       table.blocks[found][index] == packed[index])
+						++index;
+					if (index == block_size / 2) break;
+				}
+
+				if (found == used) {
+					if (used == max_blocks) {
+						table.complete = false;
+						break;
+					}
+					for (std::size_t index = 0; index < block_size / 2;
+					     ++index)
+						table.blocks[used][index] = packed[index];
+					++used;
+				}
+				if (single) shared = found + 1;
+				table.block_of[block] = static_cast<std::uint8_t>(found);
+			}
+			return table;
+		}
+
+		constexpr auto properties = make_table();
+		static_assert(properties.complete, "max_blocks is too small");
+
+		gcb property_of(char32_t ch) noexcept {
+			auto const block = properties.block_of[ch >> block_shift];
+			auto const index = ch & (block_size - 1);
+			return static_cast<gcb>(
+			    (properties.blocks[block][index / 2] >> (index % 2 * 4)) &
+			    0xF);
+		}
+
+		// what the rules say about two neighbouring code points
+		enum class pair_rule : std::uint8_t {
+			apart,
+			joined,
+			joined_after_zwj,  // GB11
+			joined_if_odd,     // GB12, GB13
+		};
+
+		constexpr pair_rule rule_for(gcb before, gcb after) {
+			auto const control = [](gcb value) {
+				return value == gcb::control || value == gcb::cr ||
+				       value == gcb::lf;
+			};
+			if (before == gcb::cr && after == gcb::lf)  // GB3
+				return pair_rule::joined;
+			if (control(before) || control(after))  // GB4, GB5
+				return pair_rule::apart;
+
+			auto const hangul =
+			    (before == gcb::l &&  // GB6
+			     (after == gcb::l || after == gcb::v || after == gcb::lv ||
+			      after == gcb::lvt)) ||
+			    ((before == gcb::lv || before == gcb::v) &&  // GB7
+			     (after == gcb::v || after == gcb::t)) ||
+			    ((before == gcb::lvt || before == gcb::t) &&  // GB8
+			     after == gcb::t);
+			if (hangul || after == gcb::extend || after == gcb::zwj ||  // GB9
+			    after == gcb::spacing_mark ||                           // GB9a
+			    before == gcb::prepend)                                 // GB9b
+				return pair_rule::joined;
+
+			if (before == gcb::zwj && after == gcb::extended_pictographic)
+				return pair_rule::joined_after_zwj;
+			if (before == gcb::regional_indicator &&
+			    after == gcb::regional_indicator)
+				return pair_rule::joined_if_odd;
+			return pair_rule::apart;  // GB999
+		}
+
+		constexpr std::size_t gcb_count =
+		    static_cast<std::size_t>(gcb::extended_pictographic) + 1;
+
+		struct pair_table {
+			pair_rule rules[gcb_count][gcb_count]{};
+		};
+
+		constexpr pair_table make_pair_table() {
+			pair_table table{};
+			for (std::size_t before = 0; before < gcb_count; ++before) {
+				for (std::size_t after = 0; after < gcb_count; ++after)
+					table.rules[before][after] = rule_for(
+					    static_cast<gcb>(before), static_cast<gcb>(after));
+			}
+			return table;
+		}
+
+		constexpr auto pair_rules = make_pair_table();
+
+		/*
+		 * What the rules need to know about the cluster so far, besides
+		 * the property of its last code point.
+		 */
+		struct cluster_state {
+			// GB11: Extended_Pictographic Extend* seen, and then a ZWJ
+			bool pictographic{};
+			bool after_zwj{};
+			// GB12 and GB13: an odd number of regional indicators so far
+			bool odd_indicators{};
+		};
+
+		bool joins(gcb before, gcb after, cluster_state const& state) noexcept {
+			switch (pair_rules.rules[static_cast<std::size_t>(before)]
+			                        [static_cast<std::size_t>(after)]) {
+				case pair_rule::joined:
+					return true;
+				case pair_rule::joined_after_zwj:
+					return state.after_zwj;
+				case pair_rule::joined_if_odd:
+					return state.odd_indicators;
+				default:
+					return false;
+			}
+		}
+
+		void advance(cluster_state& state, gcb value) noexcept {
+			switch (value) {
+				case gcb::extended_pictographic:
+					state.pictographic = true;
+					state.after_zwj = false;
+					break;
+				case gcb::extend:
+					state.after_zwj = false;
+					break;
+				case gcb::zwj:
+					state.after_zwj = state.pictographic;
+					state.pictographic = false;
+					break;
+				default:
+					state.pictographic = state.after_zwj = false;
+					break;
+			}
+			state.odd_indicators =
+			    value == gcb::regional_indicator && !state.odd_indicators;
+		}
+
+		/*
+		 * The property of the code point at the source, which is moved
+		 * past it; an ill-formed sequence is taken for a control, so it
+		 * stands alone.
+		 */
+		template <typename It>
+		gcb next_property(It& source, It sourceEnd) noexcept {
+			auto const start = source;
+			bool ok = false;
+			auto const ch = decode(source, sourceEnd, ok);
+			if (!ok || !detail::is_scalar_value(ch)) {
+				source = start + invalid_length(start, sourceEnd);
+				return gcb::control;
+			}
+			return property_of(ch);
+		}
+
+		template <typename Char>
+		bool is_ascii(Char unit) noexcept {
+			return static_cast<std::make_unsigned_t<Char>>(unit) < 0x80;
+		}
+
+		template <typename Char>
+		gcb ascii_property(Char unit) noexcept {
+			if (unit == '\r') return gcb::cr;
+			if (unit == '\n') return gcb::lf;
+			if (unit < 0x20 || unit == 0x7F) return gcb::control;
+			return gcb::other;
+		}
+
+		template <typename Char>
+		std::size_t ascii_run(Char const* data, std::size_t length) noexcept {
+			if constexpr (sizeof(Char) == 1)
+				return detail::ascii_prefix(
+				    reinterpret_cast<std::uint8_t const*>(data), length);
+			else
+				return detail::ascii_prefix(data, length);
+		}
+
+		// CR LF pairs in an ASCII run, a CR in its last unit left out
+		template <typename Char>
+		std::size_t crlf_pairs(Char const* data, std::size_t length) noexcept {
+			std::size_t pairs = 0;
+			std::size_t index = 0;
+			while (index + 1 < length) {
+				if constexpr (sizeof(Char) == 1) {
+					auto const found = std::memchr(data + index, '\r',
+					                               length - 1 - index);
+					if (!found) break;
+					index = static_cast<std::size_t>(
+					    static_cast<Char const*>(found) - data);
+				} else if (data[index] != '\r') {
+					++index;
+					continue;
+				}
+				if (data[index + 1] == '\n') ++pairs;
+				++index;
+			}
+			return pairs;
+		}
+
+		template <typename Char>
+		std::size_t cluster_length(std::basic_string_view<Char> src) noexcept {
+			if (src.empty()) return 0;
+
+			// two ASCII characters are always apart, unless they are CR LF
+			if (is_ascii(src[0]) && (src.size() == 1 || is_ascii(src[1])))
+				return src.size() > 1 && src[0] == '\r' && src[1] == '\n' ? 2
+				                                                          : 1;
+
+			auto source = src.begin();
+			auto const sourceEnd = src.end();
+			auto before = next_property(source, sourceEnd);
+			cluster_state state{};
+			advance(state, before);
+			while (source < sourceEnd) {
+				auto next = source;
+				auto const after = next_property(next, sourceEnd);
+				if (!joins(before, after, state)) break;
+				advance(state, after);
+				before = after;
+				source = next;
+			}
+			return static_cast<std::size_t>(source - src.begin());
+		}
+
+		/*
+		 * One pass, counting the breaks. Inside an ASCII run the only pair
+		 * kept together is CR LF, so the properties are looked up for its
+		 * ends alone.
+		 */
+		template <typename Char>
+		std::size_t cluster_count(std::basic_string_view<Char> src) noexcept {
+			std::size_t count = 0;
+			auto source = src.begin();
+			auto const sourceEnd = src.end();
+			// nothing joins the start of the text (GB1)
+			auto before = gcb::control;
+			cluster_state state{};
+			while (source < sourceEnd) {
+				if (is_ascii(*source)) {
+					auto const run = ascii_run(
+					    &*source, static_cast<std::size_t>(sourceEnd - source));
+					auto const last =
+					    source + static_cast<std::ptrdiff_t>(run - 1);
+					if (!joins(before, ascii_property(*source), state)) ++count;
+					count += run - 1 - crlf_pairs(&*source, run);
+					before = ascii_property(*last);
+					state = {};
+					source = last + 1;
+					continue;
+				}
+
+				auto const after = next_property(source, sourceEnd);
+				if (!joins(before, after, state)) ++count;
+				advance(state, after);
+				before = after;
+			}
+			return count;
+		}
+	}  // namespace
+
+	std::size_t grapheme_length(std::string_view src) noexcept {
+		return cluster_length(src);
+	}
+
+	std::size_t grapheme_length(std::u16string_view src) noexcept {
+		return cluster_length(src);
+	}
+
+	std::size_t grapheme_length(std::u32string_view src) noexcept {
+		return cluster_length(src);
+	}
+
+	std::size_t count_graphemes(std::string_view src) noexcept {
+		return cluster_count(src);
+	}
+
+	std::size_t count_graphemes(std::u16string_view src) noexcept {
+		return cluster_count(src);
+	}
+
+	std::size_t count_graphemes(std::u32string_view src) noexcept {
+		return cluster_count(src);
+	}
+
+#ifdef __cpp_lib_char8_t
+	std::size_t grapheme_length(std::u8string_view src) noexcept {
+		return cluster_length(src);
+	}
+
+	std::size_t count_graphemes(std::u8string_view src) noexcept {
+		return cluster_count(src);
+	}
+#endif
+}  // namespace utf
@@ -0,0 +1,181 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <cstring>
+#include <utf/utf.hpp>
+#include "codec.hpp"
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		bool is_little_endian() noexcept {
+			char16_t const probe = 1;
+			unsigned char first{};
+			std::memcpy(&first, &probe, 1);
+			return first == 1;
+		}
+
+		template <typename Unit>
+		Unit load_unit(unsigned char const* at, bool swap) noexcept {
+			Unit unit{};
+			if (!swap) {
+				std::memcpy(&unit, at, sizeof(Unit));
+				return unit;
+			}
+			unsigned char native[sizeof(Unit)];
+			for (std::size_t byte = 0; byte < sizeof(Unit); ++byte)
+				native[byte] = at[sizeof(Unit) - 1 - byte];
+			std::memcpy(&unit, native, sizeof(Unit));
+			return unit;
+		}
+
+		/*
+		 * The bytes are written strictly behind the units read, so the
+		 * units not yet read are never overwritten; every unit is loaded
+		 * before anything is stored in its place. The SIMD ASCII scan needs
+		 * the storage to actually hold native Unit objects.
+		 */
+		template <typename Unit>
+		transcode_result utf8_in_place(unsigned char* data,
+		                               std::size_t count,
+		                               bool swap,
+		                               bool typed) {
+			transcode_result result{};
+			std::size_t read = 0;
+
+			while (read < count) {
+				if constexpr (sizeof(Unit) == 2) {
+					if (typed) {
+						// ASCII runs are narrowed as they are, one byte
+						// for every two
+						auto const units = reinterpret_cast<char16_t const*>(
+						    data + read * sizeof(Unit));
+						auto const run =
+						    detail::ascii_prefix(units, count - read);
+						if (run) {
+							auto const target =
+							    reinterpret_cast<char*>(data + result.written);
+							detail::narrow_ascii(units, run, target);
+							result.written += run;
+							read += run;
+							continue;
+						}
+					}
+				}
+
+				auto next = read + 1;
+				char32_t ch = load_unit<Unit>(data + read * sizeof(Unit), swap);
+				if constexpr (sizeof(Unit) == 2) {
+					if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_HIGH_END) {
+						if (next == count) {
+							result.status = transcode_status::incomplete;
+							break;
+						}
+						char32_t const trail = load_unit<Unit>(
+						    data + next * sizeof(Unit), swap);
+						if (trail < UNI_SUR_LOW_START ||
+						    trail > UNI_SUR_LOW_END) {
+							result.status = transcode_status::invalid;
+							break;
+						}
+						ch = ((ch - UNI_SUR_HIGH_START) << halfShift) + trail -
+						     UNI_SUR_LOW_START + halfBase;
+						++next;
+					} else if (ch >= UNI_SUR_LOW_START &&
+					           ch <= UNI_SUR_LOW_END) {
+						result.status = transcode_status::invalid;
+						break;
+					}
+				}
+
+				unsigned char bytes[4];
+				auto const length = encode_utf8(ch, bytes);
+				if (result.written + length > next * sizeof(Unit)) {
+					result.status = transcode_status::output_full;
+					break;
+				}
+				std::memcpy(data + result.written, bytes, length);
+				result.written += length;
+				read = next;
+			}
+
+			result.read = read;
+			return result;
+		}
+
+		transcode_result validate_in_place(unsigned char const* data,
+		                                   std::size_t count) {
+			auto const text =
+			    std::string_view{reinterpret_cast<char const*>(data), count};
+			auto source = text.begin();
+			auto const sourceEnd = text.end();
+
+			transcode_result result{};
+			while (source < sourceEnd) {
+				auto next = source;
+				bool ok = false;
+				[[maybe_unused]] auto const ch = decode(next, sourceEnd, ok);
+				if (!ok) {
+					result.status = is_truncated(source, sourceEnd)
+					                    ? transcode_status::incomplete
+					                    : transcode_status::invalid;
+					break;
+				}
+				source = next;
+			}
+
+			result.read = static_cast<std::size_t>(source - text.begin());
+			result.written = result.read;
+			return result;
+		}
+	}  // namespace
+
+	transcode_result as_str8_in_place(std::u16string& buffer) {
+		return utf8_in_place<char16_t>(
+		    reinterpret_cast<unsigned char*>(buffer.data()), buffer.size(),
+		    false, true);
+	}
+
+	transcode_result as_str8_in_place(std::u32string& buffer) {
+		return utf8_in_place<char32_t>(
+		    reinterpret_cast<unsigned char*>(buffer.data()), buffer.size(),
+		    false, true);
+	}
+
+	transcode_result as_str8_in_place(std::vector<std::byte>& buffer,
+	                                  encoding from) {
+		auto const data = reinterpret_cast<unsigned char*>(buffer.data());
+		auto const little = is_little_endian();
+
+		transcode_result result{};
+		std::size_t unit_size = 1;
+		switch (from) {
+			case encoding::utf8:
+				result = validate_in_place(data, buffer.size());
+				break;
+			case encoding::utf16le:
+			case encoding::utf16be:
+				unit_size = 2;
+				result = utf8_in_place<char16_t>(
+				    data, buffer.size() / unit_size,
+				    little != (from == encoding::utf16le), false);
+				break;
+			case encoding::utf32le:
+			case encoding::utf32be:
+				unit_size = 4;
+				result = utf8_in_place<char32_t>(
+				    data, buffer.size() / unit_size,
+				    little != (from == encoding::utf32le), false);
+				break;
+		}
+
+		if (result.status == transcode_status::ok) {
+			// a partial unit at the end
+			if (result.read * unit_size < buffer.size())
+				result.status = transcode_status::incomplete;
+			else
+				buffer.resize(result.written);
+		}
+		return result;
+	}
+}  // namespace utf
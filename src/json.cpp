@@ -0,0 +1,288 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <cstring>
+#include <utf/json.hpp>
+#include "codec.hpp"
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		constexpr char hex_digits[] = "0123456789abcdef";
+
+		inline std::uint8_t const* bytes(char const* data) noexcept {
+			return reinterpret_cast<std::uint8_t const*>(data);
+		}
+
+		inline std::size_t plain_prefix(char const* data,
+		                                std::size_t length) noexcept {
+			return detail::json_plain_prefix(bytes(data), length);
+		}
+
+#ifdef __cpp_lib_char8_t
+		inline std::size_t plain_prefix(char8_t const* data,
+		                                std::size_t length) noexcept {
+			return detail::json_plain_prefix(
+			    reinterpret_cast<std::uint8_t const*>(data), length);
+		}
+#endif
+
+		inline std::size_t plain_prefix(char16_t const* data,
+		                                std::size_t length) noexcept {
+			return detail::json_plain_prefix(data, length);
+		}
+
+		inline std::size_t plain_prefix(char32_t const* data,
+		                                std::size_t length) noexcept {
+			std::size_t index = 0;
+			for (; index < length; ++index) {
+				auto const ch = data[index];
+				if (ch < 0x20 || ch >= 0x80 || ch == U'"' || ch == U'\\')
+					break;
+			}
+			return index;
+		}
+
+		template <typename Char>
+		void append_plain(std::string& out,
+		                  Char const* data,
+		                  std::size_t length) {
+			auto const offset = out.size();
+			out.resize(offset + length);
+			if constexpr (sizeof(Char) == 1) {
+				std::memcpy(out.data() + offset, data, length);
+			} else if constexpr (sizeof(Char) == 2) {
+				detail::narrow_ascii(data, length, out.data() + offset);
+			} else {
+				for (std::size_t index = 0; index < length; ++index)
+					out[offset + index] = static_cast<char>(data[index]);
+			}
+		}
+
+		void append_plain(std::u16string& out,
+		                  char const* data,
+		                  std::size_t length) {
+			auto const offset = out.size();
+			out.resize(offset + length);
+			detail::widen_ascii(bytes(data), length, out.data() + offset);
+		}
+
+		template <typename String>
+		void append_code_point(String& out, char32_t ch) {
+			typename String::value_type units[4];
+			auto const length = encode_units(ch, units);
+			out.append(units, length);
+		}
+
+		void append_escaped(std::string& out, char32_t ch) {
+			switch (ch) {
+				case U'"':
+					out.append("\\\"", 2);
+					return;
+				case U'\\':
+					out.append("\\\\", 2);
+					return;
+				case U'\b':
+					out.append("\\b", 2);
+					return;
+				case U'\f':
+					out.append("\\f", 2);
+					return;
+				case U'\n':
+					out.append("\\n", 2);
+					return;
+				case U'\r':
+					out.append("\\r", 2);
+					return;
+				case U'\t':
+					out.append("\\t", 2);
+					return;
+				default:
+					break;
+			}
+			char escape[] = "\\u00XX";
+			escape[4] = hex_digits[(ch >> 4) & 0xF];
+			escape[5] = hex_digits[ch & 0xF];
+			out.append(escape, 6);
+		}
+
+		template <typename Char>
+		std::string escape(std::basic_string_view<Char> src) {
+			std::string out;
+			out.reserve(src.size() + 2);
+
+			auto source = src.begin();
+			auto const sourceEnd = src.end();
+			while (source < sourceEnd) {
+				auto const offset =
+				    static_cast<std::size_t>(source - src.begin());
+				auto const run =
+				    plain_prefix(src.data() + offset, src.size() - offset);
+				append_plain(out, src.data() + offset, run);
+				source += static_cast<std::ptrdiff_t>(run);
+				if (source == sourceEnd) break;
+
+				if (static_cast<char32_t>(*source) < 0x80) {
+					append_escaped(out, static_cast<char32_t>(*source++));
+					continue;
+				}
+
+				auto const start = source;
+				bool ok = false;
+				auto const ch = decode(source, sourceEnd, ok);
+				// UTF-32 decodes any value, so it is checked here
+				if (!ok || !detail::is_scalar_value(ch)) return {};
+				if constexpr (sizeof(Char) == 1)
+					out.append(reinterpret_cast<char const*>(&*start),
+					           static_cast<std::size_t>(source - start));
+				else
+					append_code_point(out, ch);
+			}
+
+			return out;
+		}
+
+		inline int hex_value(char digit) noexcept {
+			if (digit >= '0' && digit <= '9') return digit - '0';
+			if (digit >= 'a' && digit <= 'f') return digit - 'a' + 10;
+			if (digit >= 'A' && digit <= 'F') return digit - 'A' + 10;
+			return -1;
+		}
+
+		using str8_it = std::string_view::const_iterator;
+
+		// reads the XXXX part of \uXXXX
+		inline bool read_hex(str8_it& source,
+		                     str8_it sourceEnd,
+		                     char16_t& unit) noexcept {
+			if (sourceEnd - source < 4) return false;
+			unsigned value = 0;
+			for (int digit = 0; digit < 4; ++digit) {
+				auto const nibble = hex_value(*source++);
+				if (nibble < 0) return false;
+				value = (value << 4) | static_cast<unsigned>(nibble);
+			}
+			unit = static_cast<char16_t>(value);
+			return true;
+		}
+
+		/*
+		 * Decodes the escape sequence following the reverse solidus. A high
+		 * surrogate must be followed by another \uXXXX escape holding the
+		 * low surrogate; the pair is then combined by decode_utf16.
+		 */
+		inline char32_t unescape_one(str8_it& source,
+		                             str8_it sourceEnd,
+		                             bool& ok) noexcept {
+			ok = false;
+			if (source == sourceEnd) return 0;
+			switch (*source++) {
+				case '"':
+					ok = true;
+					return U'"';
+				case '\\':
+					ok = true;
+					return U'\\';
+				case '/':
+					ok = true;
+					return U'/';
+				case 'b':
+					ok = true;
+					return U'\b';
+				case 'f':
+					ok = true;
+					return U'\f';
+				case 'n':
+					ok = true;
+					return U'\n';
+				case 'r':
+					ok = true;
+					return U'\r';
+				case 't':
+					ok = true;
+					return U'\t';
+				case 'u':
+					break;
+				default:
+					return 0;
+			}
+
+			char16_t pair[2];
+			if (!read_hex(source, sourceEnd, pair[0])) return 0;
+			if (pair[0] >= UNI_SUR_LOW_START && pair[0] <= UNI_SUR_LOW_END)
+				return 0;
+
+			auto length = 1;
+			if (pair[0] >= UNI_SUR_HIGH_START && pair[0] <= UNI_SUR_HIGH_END) {
+				if (sourceEnd - source < 2 || source[0] != '\\' ||
+				    source[1] != 'u')
+					return 0;
+				source += 2;
+				if (!read_hex(source, sourceEnd, pair[1])) return 0;
+				length = 2;
+			}
+
+			char16_t const* units = pair;
+			char16_t const* const unitsEnd = pair + length;
+			return decode_utf16(units, unitsEnd, ok);
+		}
+
+		template <typename String>
+		String unescape(std::string_view src) {
+			String out;
+			out.reserve(src.size());
+
+			auto source = src.begin();
+			auto const sourceEnd = src.end();
+			while (source < sourceEnd) {
+				auto const offset =
+				    static_cast<std::size_t>(source - src.begin());
+				auto const run =
+				    plain_prefix(src.data() + offset, src.size() - offset);
+				append_plain(out, src.data() + offset, run);
+				source += static_cast<std::ptrdiff_t>(run);
+				if (source == sourceEnd) break;
+
+				bool ok = false;
+				auto const uchar = static_cast<uint8_t>(*source);
+				if (uchar == '\\') {
+					++source;
+					auto const ch = unescape_one(source, sourceEnd, ok);
+					if (!ok) return {};
+					append_code_point(out, ch);
+					continue;
+				}
+
+				// a raw control character or an unescaped quotation mark
+				if (uchar < 0x80) return {};
+
+				auto const start = source;
+				auto const ch = decode(source, sourceEnd, ok);
+				if (!ok) return {};
+				if constexpr (sizeof(typename String::value_type) == 1)
+					out.append(&*start,
+					           static_cast<std::size_t>(source - start));
+				else
+					append_code_point(out, ch);
+			}
+
+			return out;
+		}
+	}  // namespace
+
+	std::string json_escape(std::string_view src) { return escape(src); }
+	std::string json_escape(std::u16string_view src) { return escape(src); }
+	std::string json_escape(std::u32string_view src) { return escape(src); }
+
+	std::string json_unescape(std::string_view src) {
+		return unescape<std::string>(src);
+	}
+
+	std::u16string json_unescape_u16(std::string_view src) {
+		return unescape<std::u16string>(src);
+	}
+
+#ifdef __cpp_lib_char8_t
+	std::string json_escape(std::u8string_view src) { return escape(src); }
+#endif
+}  // namespace utf
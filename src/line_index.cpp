@@ -0,0 +1,285 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <algorithm>
+#include <utf/line_index.hpp>
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		constexpr std::size_t checkpoint_spacing = 512;
+
+		template <typename Char>
+		std::uint8_t const* bytes(Char const* data) noexcept {
+			return reinterpret_cast<std::uint8_t const*>(data);
+		}
+
+		// true for the units which do not start a code point
+		template <typename Char>
+		bool is_trailing(std::basic_string_view<Char> text,
+		                 std::size_t offset) noexcept {
+			if (offset == 0 || offset >= text.size()) return false;
+			if constexpr (sizeof(Char) == 1)
+				return detail::is_continuation(
+				    static_cast<std::uint8_t>(text[offset]));
+			else
+				return detail::is_low_surrogate(text[offset]);
+		}
+
+		template <typename Char>
+		std::size_t floor_start(std::basic_string_view<Char> text,
+		                        std::size_t offset) noexcept {
+			for (int step = 0; step < 3 && is_trailing(text, offset); ++step)
+				--offset;
+			return offset;
+		}
+
+		template <typename Char>
+		std::size_t ceil_start(std::basic_string_view<Char> text,
+		                       std::size_t offset) noexcept {
+			for (int step = 0; step < 3 && is_trailing(text, offset); ++step)
+				++offset;
+			return offset;
+		}
+	}  // namespace
+
+	template <typename Char>
+	basic_line_index<Char>::basic_line_index(view_type text) : text_{text} {
+		add_checkpoints(checkpoints_.front(), text.size(), checkpoints_,
+		                &line_starts_);
+	}
+
+	template <typename Char>
+	std::size_t basic_line_index<Char>::line_start(
+	    std::size_t line) const noexcept {
+		if (line >= line_starts_.size()) return text_.size();
+		return line_starts_[line];
+	}
+
+	template <typename Char>
+	line_column basic_line_index<Char>::position(
+	    std::size_t offset,
+	    column_unit unit) const noexcept {
+		offset = floor_start(text_, std::min(offset, text_.size()));
+		auto const next_line = std::upper_bound(line_starts_.begin(),
+		                                        line_starts_.end(), offset);
+		auto const line =
+		    static_cast<std::size_t>(next_line - line_starts_.begin()) - 1;
+
+		auto const start = counts_at(line_starts_[line]);
+		auto const here = counts_at(offset);
+		if (unit == column_unit::utf16)
+			return {line, here.utf16 - start.utf16};
+		return {line, here.code_points - start.code_points};
+	}
+
+	template <typename Char>
+	std::size_t basic_line_index<Char>::offset(
+	    line_column position,
+	    column_unit unit) const noexcept {
+		if (position.line >= line_starts_.size()) return text_.size();
+		auto const end = position.line + 1 < line_starts_.size()
+		                     ? line_starts_[position.line + 1] - 1
+		                     : text_.size();
+
+		auto const value = [unit](checkpoint const& at) {
+			return unit == column_unit::utf16 ? at.utf16 : at.code_points;
+		};
+		auto const start = counts_at(line_starts_[position.line]);
+		auto const target = value(start) + position.column;
+
+		// the last checkpoint not past the target
+		auto const after = std::upper_bound(
+		    checkpoints_.begin(), checkpoints_.end(), target,
+		    [&](std::size_t count, checkpoint const& at) {
+			    return count < value(at);
+		    });
+		auto here = std::prev(after)->offset > start.offset ? *std::prev(after)
+		                                                    : start;
+		if (here.offset > end) return end;
+
+		while (here.offset < end) {
+			auto const next = next_code_point(here);
+			if (value(next) > target) break;
+			here = next;
+		}
+		return here.offset;
+	}
+
+	template <typename Char>
+	void basic_line_index<Char>::update(view_type text,
+	                                    std::size_t offset,
+	                                    std::size_t removed,
+	                                    std::size_t inserted) {
+		text_ = text;
+		auto const moved = [=](std::size_t old_offset) {
+			return old_offset - removed + inserted;
+		};
+
+		// the lines started by the newlines of the removed range go, the
+		// ones of the inserted range come in their place
+		auto const first = static_cast<std::size_t>(
+		    std::upper_bound(line_starts_.begin(), line_starts_.end(),
+		                     offset) -
+		    line_starts_.begin());
+		auto const last = static_cast<std::size_t>(
+		    std::upper_bound(line_starts_.begin(), line_starts_.end(),
+		                     offset + removed) -
+		    line_starts_.begin());
+		for (auto index = last; index < line_starts_.size(); ++index)
+			line_starts_[index] = moved(line_starts_[index]);
+		std::vector<std::size_t> added;
+		find_lines(offset, offset + inserted, added);
+		auto const lines_at =
+		    line_starts_.begin() + static_cast<std::ptrdiff_t>(first);
+		line_starts_.erase(
+		    lines_at, line_starts_.begin() + static_cast<std::ptrdiff_t>(last));
+		line_starts_.insert(
+		    line_starts_.begin() + static_cast<std::ptrdiff_t>(first),
+		    added.begin(), added.end());
+
+		// the counts are rebuilt from the last checkpoint before the edit
+		// up to the first one after it, which moves with all the later ones
+		auto const by_offset = [](checkpoint const& at, std::size_t value) {
+			return at.offset < value;
+		};
+		auto const before = static_cast<std::size_t>(
+		    std::upper_bound(checkpoints_.begin(), checkpoints_.end(), offset,
+		                     [](std::size_t value, checkpoint const& at) {
+			                     return value < at.offset;
+		                     }) -
+		    checkpoints_.begin() - 1);
+		auto const after = std::max(
+		    before + 1,
+		    static_cast<std::size_t>(
+		        std::lower_bound(checkpoints_.begin(), checkpoints_.end(),
+		                         offset + removed, by_offset) -
+		        checkpoints_.begin()));
+
+		auto const rebuilt_end = after < checkpoints_.size()
+		                             ? moved(checkpoints_[after].offset)
+		                             : text_.size();
+		std::vector<checkpoint> rebuilt;
+		auto const reached =
+		    add_checkpoints(checkpoints_[before], rebuilt_end, rebuilt);
+		if (after < checkpoints_.size()) {
+			auto const old = checkpoints_[after];
+			for (auto index = after; index < checkpoints_.size(); ++index) {
+				auto& at = checkpoints_[index];
+				at.offset = moved(at.offset);
+				at.code_points = at.code_points - old.code_points +
+				                 reached.code_points;
+				at.utf16 = at.utf16 - old.utf16 + reached.utf16;
+			}
+		}
+		auto const checkpoints_at =
+		    checkpoints_.begin() + static_cast<std::ptrdiff_t>(before + 1);
+		checkpoints_.erase(
+		    checkpoints_at,
+		    checkpoints_.begin() + static_cast<std::ptrdiff_t>(after));
+		checkpoints_.insert(
+		    checkpoints_.begin() + static_cast<std::ptrdiff_t>(before + 1),
+		    rebuilt.begin(), rebuilt.end());
+	}
+
+	template <typename Char>
+	void basic_line_index<Char>::find_lines(
+	    std::size_t begin,
+	    std::size_t end,
+	    std::vector<std::size_t>& starts) const {
+		auto const data = text_.data();
+		while (begin < end) {
+			std::size_t found{};
+			if constexpr (sizeof(Char) == 1)
+				found = detail::find_newline(bytes(data + begin), end - begin);
+			else
+				found = detail::find_newline(data + begin, end - begin);
+			if (found == end - begin) break;
+			begin += found + 1;
+			starts.push_back(begin);
+		}
+	}
+
+	/*
+	 * Appends checkpoints after `from`, one every checkpoint_spacing units
+	 * (moved to the start of a code point), up to the end; returns the
+	 * counts at the end itself. With `starts`, the newlines of each stretch
+	 * are found right before it is counted, while it is still in L1, so
+	 * the text is read from memory once.
+	 */
+	template <typename Char>
+	typename basic_line_index<Char>::checkpoint
+	basic_line_index<Char>::add_checkpoints(
+	    checkpoint from,
+	    std::size_t end,
+	    std::vector<checkpoint>& out,
+	    std::vector<std::size_t>* starts) const {
+		auto const counted = [&](checkpoint at, std::size_t to) {
+			if (starts) find_lines(at.offset, to, *starts);
+			auto const data = text_.data() + at.offset;
+			auto const length = to - at.offset;
+			if constexpr (sizeof(Char) == 1) {
+				auto const code_points =
+				    detail::count_code_points(bytes(data), length);
+				at.code_points += code_points;
+				at.utf16 += code_points +
+				            detail::count_four_byte_leads(bytes(data), length);
+			} else {
+				at.code_points += detail::count_code_points(data, length);
+				at.utf16 += length;
+			}
+			at.offset = to;
+			return at;
+		};
+
+		while (end - from.offset > checkpoint_spacing) {
+			auto const next =
+			    ceil_start(text_, from.offset + checkpoint_spacing);
+			from = counted(from, next);
+			out.push_back(from);
+		}
+		return counted(from, end);
+	}
+
+	template <typename Char>
+	typename basic_line_index<Char>::checkpoint
+	basic_line_index<Char>::counts_at(std::size_t offset) const noexcept {
+		auto const after = std::upper_bound(
+		    checkpoints_.begin(), checkpoints_.end(), offset,
+		    [](std::size_t value, checkpoint const& at) {
+			    return value < at.offset;
+		    });
+		auto here = *std::prev(after);
+		while (here.offset < offset)
+			here = next_code_point(here);
+		return here;
+	}
+
+	/*
+	 * Counts the same way the bulk counting does: every unit which does not
+	 * continue a code point starts a new one.
+	 */
+	template <typename Char>
+	typename basic_line_index<Char>::checkpoint
+	basic_line_index<Char>::next_code_point(checkpoint at) const noexcept {
+		if constexpr (sizeof(Char) == 1) {
+			auto const lead = static_cast<std::uint8_t>(text_[at.offset]);
+			if (!detail::is_continuation(lead)) {
+				++at.code_points;
+				at.utf16 += lead >= 0xF0 ? 2 : 1;
+			}
+		} else {
+			if (!detail::is_low_surrogate(text_[at.offset])) ++at.code_points;
+			++at.utf16;
+		}
+		++at.offset;
+		while (is_trailing(text_, at.offset)) {
+			if constexpr (sizeof(Char) != 1) ++at.utf16;
+			++at.offset;
+		}
+		return at;
+	}
+
+	template class basic_line_index<char>;
+	template class basic_line_index<char16_t>;
+}  // namespace utf
@@ -0,0 +1,153 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <utf/segments.hpp>
+
+namespace utf {
+	namespace {
+		class segment_writer {
+		public:
+			segment_writer(segment_source const& next,
+			               segments_result& result)
+			    : next_{next}, result_{result} {}
+
+			// false, if there are no more buffers
+			bool start() {
+				current_ = next_();
+				used_ = 0;
+				return current_.length != 0;
+			}
+
+			bool advance() {
+				if (used_) result_.segments.push_back({current_.base, used_});
+				return start();
+			}
+
+			void finish() {
+				if (used_) result_.segments.push_back({current_.base, used_});
+				used_ = 0;
+			}
+
+			char* data() const noexcept {
+				return static_cast<char*>(current_.base) + used_;
+			}
+			std::size_t room() const noexcept {
+				return current_.length - used_;
+			}
+			void commit(std::size_t length) noexcept { used_ += length; }
+
+			/*
+			 * Spreads the bytes over as many buffers as it takes. If the
+			 * buffers run out, nothing of the bytes is kept.
+			 */
+			bool spread(char const* bytes, std::size_t length) {
+				auto const listed = result_.segments.size();
+				auto const current = current_;
+				auto const used = used_;
+				for (std::size_t index = 0; index < length; ++index) {
+					if (!room() && !advance()) {
+						result_.segments.resize(listed);
+						current_ = current;
+						used_ = used;
+						return false;
+					}
+					data()[0] = bytes[index];
+					commit(1);
+				}
+				return true;
+			}
+
+		private:
+			segment_source const& next_;
+			segments_result& result_;
+			segment current_{};
+			std::size_t used_{};
+		};
+
+		template <typename CharIn>
+		segments_result transcode_into(std::basic_string_view<CharIn> src,
+		                               segment_source const& next,
+		                               on_error errors,
+		                               code_point_split split) {
+			segments_result result{};
+			if (src.empty()) return result;
+
+			segment_writer out{next, result};
+			if (!out.start()) {
+				result.status = transcode_status::output_full;
+				return result;
+			}
+
+			while (true) {
+				auto const rest = src.substr(result.read);
+				auto const part =
+				    transcode(rest, out.data(), out.room(), errors);
+				out.commit(part.written);
+				result.read += part.read;
+				result.written += part.written;
+				if (part.status != transcode_status::output_full) {
+					result.status = part.status;
+					break;
+				}
+
+				if (split == code_point_split::allowed && out.room()) {
+					// whatever fits in four bytes, which is at least the
+					// code point that did not fit here
+					char bytes[4];
+					auto const head = src.substr(result.read);
+					auto const whole =
+					    transcode(head, bytes, sizeof(bytes), errors);
+					if (!whole.read) {
+						result.status = whole.status;
+						break;
+					}
+					if (!out.spread(bytes, whole.written)) {
+						result.status = transcode_status::output_full;
+						break;
+					}
+					result.read += whole.read;
+					result.written += whole.written;
+					continue;
+				}
+
+				if (!out.advance()) {
+					result.status = transcode_status::output_full;
+					break;
+				}
+			}
+
+			out.finish();
+			return result;
+		}
+	}  // namespace
+
+	segments_result transcode_segments(std::string_view src,
+	                                   segment_source const& next,
+	                                   on_error errors,
+	                                   code_point_split split) {
+		return transcode_into(src, next, errors, split);
+	}
+
+	segments_result transcode_segments(std::u16string_view src,
+	                                   segment_source const& next,
+	                                   on_error errors,
+	                                   code_point_split split) {
+		return transcode_into(src, next, errors, split);
+	}
+
+	segments_result transcode_segments(std::u32string_view src,
+	                                   segment_source const& next,
+	                                   on_error errors,
+	                                   code_point_split split) {
+		return transcode_into(src, next, errors, split);
+	}
+
+#ifdef __cpp_lib_char8_t
+	segments_result transcode_segments(std::u8string_view src,
+	                                   segment_source const& next,
+	                                   on_error errors,
+	                                   code_point_split split) {
+		return transcode_into(src, next, errors, split);
+	}
+#endif
+}  // namespace utf
@@ -0,0 +1,870 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(UTF_NO_SIMD) &&                         \
+    (defined(__SSE2__) || defined(_M_X64) ||         \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define UTF_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif !defined(UTF_NO_SWAR)
+// no vector ISA: plain 64-bit words, eight bytes at a time
+#define UTF_SIMD_SWAR 1
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && \
+                        __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define UTF_SWAR_LITTLE_ENDIAN 1
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace utf::detail {
+	inline unsigned popcount(std::uint32_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned count = 0;
+		for (; mask; mask &= mask - 1)
+			++count;
+		return count;
+#else
+		return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+	}
+
+	inline unsigned popcount(std::uint64_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned count = 0;
+		for (; mask; mask &= mask - 1)
+			++count;
+		return count;
+#else
+		return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+	}
+
+	// mask must not be zero
+	inline unsigned ctz(std::uint32_t mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index{};
+		_BitScanForward(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+	inline bool is_continuation(std::uint8_t byte) noexcept {
+		return (byte & 0xC0) == 0x80;
+	}
+
+	inline bool is_low_surrogate(char16_t unit) noexcept {
+		return (unit & 0xFC00) == 0xDC00;
+	}
+
+	// neither a surrogate, nor above U+10FFFF
+	inline bool is_scalar_value(char32_t ch) noexcept {
+		return ch <= 0x10FFFF && (ch & 0xFFFFF800) != 0xD800;
+	}
+
+#ifdef UTF_SIMD_SSE2
+	inline __m128i load(void const* ptr) noexcept {
+		return _mm_loadu_si128(static_cast<__m128i const*>(ptr));
+	}
+
+	// one bit per byte
+	inline std::uint32_t movemask8(__m128i mask) noexcept {
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(mask));
+	}
+
+	// one bit per 16-bit lane, lanes must be either all-ones or all-zeros
+	inline std::uint32_t movemask16(__m128i mask) noexcept {
+		return static_cast<std::uint32_t>(
+		    _mm_movemask_epi8(_mm_packs_epi16(mask, _mm_setzero_si128())));
+	}
+#endif
+
+#ifdef UTF_SIMD_SWAR
+	inline std::uint64_t load64(void const* ptr) noexcept {
+		std::uint64_t word{};
+		std::memcpy(&word, ptr, sizeof(word));
+		return word;
+	}
+
+	inline void store64(void* ptr, std::uint64_t word) noexcept {
+		std::memcpy(ptr, &word, sizeof(word));
+	}
+
+	inline constexpr std::uint64_t bytes_of(std::uint8_t byte) noexcept {
+		return 0x0101'0101'0101'0101ull * byte;
+	}
+
+	inline constexpr std::uint64_t units_of(char16_t unit) noexcept {
+		return 0x0001'0001'0001'0001ull * unit;
+	}
+
+	/*
+	 * High bit set in every lane below the limit (at most 0x80 for bytes,
+	 * 0x8000 for units); exact as long as it is only tested for non-zero.
+	 */
+	inline constexpr std::uint64_t bytes_below(std::uint64_t word,
+	                                           std::uint8_t limit) noexcept {
+		return (word - bytes_of(limit)) & ~word & bytes_of(0x80);
+	}
+
+	inline constexpr std::uint64_t units_below(std::uint64_t word,
+	                                           char16_t limit) noexcept {
+		return (word - units_of(limit)) & ~word & units_of(0x8000);
+	}
+#endif
+
+	/*
+	 * Length of the run of 7-bit characters at the start of the buffer.
+	 * The SWAR loops only find the word with the first hit; the scalar
+	 * loop after them finds the unit itself, whatever the byte order.
+	 */
+	inline std::size_t ascii_prefix(std::uint8_t const* data,
+	                                 std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		for (; index + 16 <= length; index += 16) {
+			auto const high_bits = movemask8(load(data + index));
+			if (high_bits) return index + ctz(high_bits);
+		}
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 8 <= length; index += 8) {
+			if (load64(data + index) & bytes_of(0x80)) break;
+		}
+#endif
+		while (index < length && data[index] < 0x80)
+			++index;
+		return index;
+	}
+
+	inline std::size_t ascii_prefix(char16_t const* data,
+	                                 std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const high_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+		auto const zero = _mm_setzero_si128();
+		for (; index + 8 <= length; index += 8) {
+			auto const wide = _mm_cmpeq_epi16(
+			    _mm_and_si128(load(data + index), high_bits), zero);
+			auto const mask = ~movemask16(wide) & 0xFF;
+			if (mask) return index + ctz(mask);
+		}
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 4 <= length; index += 4) {
+			if (load64(data + index) & units_of(0xFF80)) break;
+		}
+#endif
+		while (index < length && data[index] < 0x80)
+			++index;
+		return index;
+	}
+
+	inline std::size_t ascii_prefix(char32_t const* data,
+	                                 std::size_t length) noexcept {
+		std::size_t index = 0;
+		while (index < length && data[index] < 0x80)
+			++index;
+		return index;
+	}
+
+	/*
+	 * Checks the pairing of surrogates in [index, end) one unit at a time;
+	 * expect_low carries an open high surrogate over to the next call.
+	 * Returns the offset of the first unpaired surrogate, or end.
+	 */
+	inline std::size_t utf16_check_pairs(char16_t const* data,
+	                                     std::size_t index,
+	                                     std::size_t end,
+	                                     bool& expect_low) noexcept {
+		for (; index < end; ++index) {
+			auto const unit = data[index];
+			if (is_low_surrogate(unit) != expect_low)
+				return expect_low ? index - 1 : index;
+			expect_low = (unit & 0xFC00) == 0xD800;
+		}
+		return end;
+	}
+
+	/*
+	 * Offset of the first unpaired surrogate, or the length for valid
+	 * UTF-16. Blocks without surrogates cost a single test; in the other
+	 * blocks, the mask of low surrogates must be the mask of high ones
+	 * moved by one unit, with the high surrogate ending the previous
+	 * block carried in.
+	 */
+	inline std::size_t utf16_invalid_offset(char16_t const* data,
+	                                        std::size_t length) noexcept {
+		std::size_t index = 0;
+		bool expect_low = false;
+#ifdef UTF_SIMD_SSE2
+		auto const top5 = _mm_set1_epi16(static_cast<short>(0xF800));
+		auto const top6 = _mm_set1_epi16(static_cast<short>(0xFC00));
+		auto const high = _mm_set1_epi16(static_cast<short>(0xD800));
+		auto const low = _mm_set1_epi16(static_cast<short>(0xDC00));
+		auto const matches = [](__m128i first, __m128i second, __m128i mask,
+		                        __m128i value) {
+			return movemask16(
+			           _mm_cmpeq_epi16(_mm_and_si128(first, mask), value)) |
+			       movemask16(
+			           _mm_cmpeq_epi16(_mm_and_si128(second, mask), value))
+			           << 8;
+		};
+		for (; index + 16 <= length; index += 16) {
+			auto const first = load(data + index);
+			auto const second = load(data + index + 8);
+			if (!matches(first, second, top5, high)) {
+				if (expect_low) return index - 1;
+				continue;
+			}
+
+			auto const highs = matches(first, second, top6, high);
+			auto const lows = matches(first, second, top6, low);
+			auto const expected = ((highs << 1) | (expect_low ? 1u : 0u)) &
+			                      0xFFFF;
+			if (auto const bad = lows ^ expected) {
+				// either a low surrogate out of place, or a high one with
+				// no low surrogate after it
+				auto const at = ctz(bad);
+				return (lows >> at) & 1 ? index + at : index + at - 1;
+			}
+			expect_low = (highs >> 15) != 0;
+		}
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 8 <= length; index += 8) {
+			auto const first =
+			    (load64(data + index) & units_of(0xF800)) ^ units_of(0xD800);
+			auto const second = (load64(data + index + 4) & units_of(0xF800)) ^
+			                    units_of(0xD800);
+			if (!(units_below(first, 1) | units_below(second, 1))) {
+				if (expect_low) return index - 1;
+				continue;
+			}
+			auto const end =
+			    utf16_check_pairs(data, index, index + 8, expect_low);
+			if (end != index + 8) return end;
+		}
+#endif
+		auto const end = utf16_check_pairs(data, index, length, expect_low);
+		if (end != length) return end;
+		return expect_low ? length - 1 : length;
+	}
+
+	/*
+	 * Length of the run of Unicode scalar values at the start of the
+	 * buffer. SSE2 has signed comparisons only, so the values are moved by
+	 * 2^31 before the range check.
+	 */
+	inline std::size_t utf32_valid_prefix(char32_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const sign = _mm_set1_epi32(INT32_MIN);
+		auto const max = _mm_set1_epi32(INT32_MIN + 0x10FFFF);
+		auto const surrogate_bits = _mm_set1_epi32(-0x800);
+		auto const surrogate = _mm_set1_epi32(0xD800);
+		auto const invalid = [&](__m128i values) {
+			return _mm_or_si128(
+			    _mm_cmpgt_epi32(_mm_xor_si128(values, sign), max),
+			    _mm_cmpeq_epi32(_mm_and_si128(values, surrogate_bits),
+			                    surrogate));
+		};
+		for (; index + 8 <= length; index += 8) {
+			auto const bad = _mm_or_si128(invalid(load(data + index)),
+			                              invalid(load(data + index + 4)));
+			if (movemask8(bad)) break;
+		}
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 4 <= length; index += 4) {
+			auto const valid = is_scalar_value(data[index]) &
+			                   is_scalar_value(data[index + 1]) &
+			                   is_scalar_value(data[index + 2]) &
+			                   is_scalar_value(data[index + 3]);
+			if (!valid) break;
+		}
+#endif
+		while (index < length && is_scalar_value(data[index]))
+			++index;
+		return index;
+	}
+
+	/*
+	 * Length of the run of code points below U+0300 at the start of the
+	 * buffer; none of them has a decomposition or a combining class. In
+	 * UTF-8 those are the bytes below 0xCC, where each C2-CB lead has to
+	 * be followed by one continuation byte, and no other byte may be. The
+	 * run ends on a code point boundary.
+	 */
+	inline std::size_t below_u0300_prefix(std::uint8_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const zero = _mm_setzero_si128();
+		auto const last_lead = _mm_set1_epi8(static_cast<char>(0xCB));
+		auto const last_continuation = _mm_set1_epi8(static_cast<char>(0xBF));
+		auto const overlong_bits = _mm_set1_epi8(static_cast<char>(0xFE));
+		auto const overlong = _mm_set1_epi8(static_cast<char>(0xC0));
+		std::uint32_t carry = 0;  // a lead ending the previous block
+		for (; index + 16 <= length; index += 16) {
+			auto const block = load(data + index);
+			auto const small = movemask8(
+			    _mm_cmpeq_epi8(_mm_subs_epu8(block, last_lead), zero));
+			auto const not_leads = movemask8(_mm_cmpeq_epi8(
+			    _mm_subs_epu8(block, last_continuation), zero));
+			auto const leads = ~not_leads & 0xFFFF;
+			auto const continuations = movemask8(block) & ~leads;
+			auto const overlongs = movemask8(_mm_cmpeq_epi8(
+			    _mm_and_si128(block, overlong_bits), overlong));
+			if (small != 0xFFFF || overlongs ||
+			    continuations != (((leads << 1) | carry) & 0xFFFF))
+				break;
+			carry = leads >> 15;
+		}
+		index -= carry;
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 8 <= length; index += 8) {
+			if (load64(data + index) & bytes_of(0x80)) break;
+		}
+#endif
+		while (index < length) {
+			auto const byte = data[index];
+			if (byte < 0x80) {
+				++index;
+				continue;
+			}
+			if (byte < 0xC2 || byte > 0xCB || index + 1 == length ||
+			    !is_continuation(data[index + 1]))
+				break;
+			index += 2;
+		}
+		return index;
+	}
+
+	inline std::size_t below_u0300_prefix(char16_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const zero = _mm_setzero_si128();
+		auto const last = _mm_set1_epi16(0x2FF);
+		for (; index + 8 <= length; index += 8) {
+			auto const small = _mm_cmpeq_epi16(
+			    _mm_subs_epu16(load(data + index), last), zero);
+			if (movemask8(small) != 0xFFFF) break;
+		}
+#elif defined(UTF_SIMD_SWAR)
+		// the high bit of a lane is set from 0x0300 on, without carries
+		auto const low_bits = units_of(0x7FFF);
+		for (; index + 4 <= length; index += 4) {
+			auto const word = load64(data + index);
+			if ((((word & low_bits) + units_of(0x8000 - 0x300)) | word) &
+			    units_of(0x8000))
+				break;
+		}
+#endif
+		while (index < length && data[index] < 0x300)
+			++index;
+		return index;
+	}
+
+	inline std::size_t below_u0300_prefix(char32_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const sign = _mm_set1_epi32(INT32_MIN);
+		auto const limit = _mm_set1_epi32(INT32_MIN + 0x300);
+		for (; index + 8 <= length; index += 8) {
+			auto const small = _mm_and_si128(
+			    _mm_cmplt_epi32(_mm_xor_si128(load(data + index), sign),
+			                    limit),
+			    _mm_cmplt_epi32(_mm_xor_si128(load(data + index + 4), sign),
+			                    limit));
+			if (movemask8(small) != 0xFFFF) break;
+		}
+#endif
+		while (index < length && data[index] < 0x300)
+			++index;
+		return index;
+	}
+
+	/*
+	 * Length of the run of bytes at the start of the buffer, which are
+	 * neither control characters, nor non-ASCII bytes, nor the quotation
+	 * mark or the reverse solidus, i.e. which are copied as-is into and out
+	 * of a JSON string.
+	 */
+	inline std::size_t json_plain_prefix(std::uint8_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		// as signed bytes, both 0x00-0x1F and 0x80-0xFF are below 0x20
+		auto const space = _mm_set1_epi8(0x20);
+		auto const quote = _mm_set1_epi8('"');
+		auto const backslash = _mm_set1_epi8('\\');
+		for (; index + 16 <= length; index += 16) {
+			auto const block = load(data + index);
+			auto const special = _mm_or_si128(
+			    _mm_cmplt_epi8(block, space),
+			    _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+			                 _mm_cmpeq_epi8(block, backslash)));
+			auto const mask = movemask8(special);
+			if (mask) return index + ctz(mask);
+		}
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 8 <= length; index += 8) {
+			auto const word = load64(data + index);
+			auto const special =
+			    (word & bytes_of(0x80)) | bytes_below(word, 0x20) |
+			    bytes_below(word ^ bytes_of('"'), 1) |
+			    bytes_below(word ^ bytes_of('\\'), 1);
+			if (special) break;
+		}
+#endif
+		for (; index < length; ++index) {
+			auto const byte = data[index];
+			if (byte < 0x20 || byte >= 0x80 || byte == '"' || byte == '\\')
+				break;
+		}
+		return index;
+	}
+
+	inline std::size_t json_plain_prefix(char16_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		// (unit - 0x20) must be below 0x60, compared as unsigned by flipping
+		// the sign bit before a signed comparison
+		auto const space = _mm_set1_epi16(0x20);
+		auto const sign = _mm_set1_epi16(static_cast<short>(0x8000));
+		auto const last = _mm_set1_epi16(static_cast<short>(0x8000 + 0x5F));
+		auto const quote = _mm_set1_epi16('"');
+		auto const backslash = _mm_set1_epi16('\\');
+		for (; index + 8 <= length; index += 8) {
+			auto const block = load(data + index);
+			auto const shifted =
+			    _mm_xor_si128(_mm_sub_epi16(block, space), sign);
+			auto const special = _mm_or_si128(
+			    _mm_cmpgt_epi16(shifted, last),
+			    _mm_or_si128(_mm_cmpeq_epi16(block, quote),
+			                 _mm_cmpeq_epi16(block, backslash)));
+			auto const mask = movemask16(special);
+			if (mask) return index + ctz(mask);
+		}
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 4 <= length; index += 4) {
+			auto const word = load64(data + index);
+			auto const special =
+			    (word & units_of(0xFF80)) | units_below(word, 0x20) |
+			    units_below(word ^ units_of(u'"'), 1) |
+			    units_below(word ^ units_of(u'\\'), 1);
+			if (special) break;
+		}
+#endif
+		for (; index < length; ++index) {
+			auto const unit = data[index];
+			if (unit < 0x20 || unit >= 0x80 || unit == u'"' || unit == u'\\')
+				break;
+		}
+		return index;
+	}
+
+	/*
+	 * Copies 7-bit units between 8- and 16-bit buffers.
+	 */
+	inline void widen_ascii(std::uint8_t const* src,
+	                        std::size_t length,
+	                        char16_t* dst) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const zero = _mm_setzero_si128();
+		for (; index + 16 <= length; index += 16) {
+			auto const block = load(src + index);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + index),
+			                 _mm_unpacklo_epi8(block, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + index + 8),
+			                 _mm_unpackhi_epi8(block, zero));
+		}
+#elif defined(UTF_SWAR_LITTLE_ENDIAN)
+		// spreads four bytes into four 16-bit lanes
+		auto const spread = [](std::uint64_t half) {
+			half = (half | (half << 16)) & 0x0000'FFFF'0000'FFFFull;
+			return (half | (half << 8)) & 0x00FF'00FF'00FF'00FFull;
+		};
+		for (; index + 8 <= length; index += 8) {
+			auto const word = load64(src + index);
+			store64(dst + index, spread(word & 0xFFFF'FFFFull));
+			store64(dst + index + 4, spread(word >> 32));
+		}
+#endif
+		for (; index < length; ++index)
+			dst[index] = src[index];
+	}
+
+	inline void narrow_ascii(char16_t const* src,
+	                         std::size_t length,
+	                         char* dst) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		for (; index + 16 <= length; index += 16) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + index),
+			                 _mm_packus_epi16(load(src + index),
+			                                  load(src + index + 8)));
+		}
+#elif defined(UTF_SWAR_LITTLE_ENDIAN)
+		// gathers the low bytes of four 16-bit lanes
+		auto const gather = [](std::uint64_t word) {
+			word = (word | (word >> 8)) & 0x0000'FFFF'0000'FFFFull;
+			return (word | (word >> 16)) & 0xFFFF'FFFFull;
+		};
+		for (; index + 8 <= length; index += 8) {
+			store64(dst + index, gather(load64(src + index)) |
+			                         (gather(load64(src + index + 4)) << 32));
+		}
+#endif
+		for (; index < length; ++index)
+			dst[index] = static_cast<char>(src[index]);
+	}
+
+	/*
+	 * Cache hints of the large-input path: the input is fetched ahead of
+	 * the decoder and the output goes to memory with non-temporal stores,
+	 * without evicting anything on its way; stream_fence orders them with
+	 * the stores after it.
+	 */
+	inline void prefetch(void const* ptr) noexcept {
+#ifdef UTF_SIMD_SSE2
+		_mm_prefetch(static_cast<char const*>(ptr), _MM_HINT_NTA);
+#else
+		static_cast<void>(ptr);
+#endif
+	}
+
+	inline void stream_copy(void* dst,
+	                        void const* src,
+	                        std::size_t size) noexcept {
+#ifdef UTF_SIMD_SSE2
+		auto out = static_cast<std::uint8_t*>(dst);
+		auto in = static_cast<std::uint8_t const*>(src);
+		auto const head = std::min(
+		    size, (16 - reinterpret_cast<std::uintptr_t>(out) % 16) % 16);
+		std::memcpy(out, in, head);
+		out += head;
+		in += head;
+		size -= head;
+		for (; size >= 16; size -= 16, out += 16, in += 16)
+			_mm_stream_si128(reinterpret_cast<__m128i*>(out), load(in));
+		std::memcpy(out, in, size);
+#else
+		std::memcpy(dst, src, size);
+#endif
+	}
+
+	inline void stream_fence() noexcept {
+#ifdef UTF_SIMD_SSE2
+		_mm_sfence();
+#endif
+	}
+
+	/*
+	 * Number of code points in a well-formed UTF-8 buffer; every byte, which
+	 * is not a continuation byte, starts a new code point.
+	 */
+	inline std::size_t count_code_points(std::uint8_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t count = 0;
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		// as signed bytes, 0x80-0xBF are the -128..-65 range
+		auto const last_continuation = _mm_set1_epi8(-65);
+		for (; index + 16 <= length; index += 16) {
+			auto const leads =
+			    _mm_cmpgt_epi8(load(data + index), last_continuation);
+			count += popcount(movemask8(leads));
+		}
+#elif defined(UTF_SIMD_SWAR)
+		// 10xxxxxx: the high bit set, the one below it clear
+		for (; index + 8 <= length; index += 8) {
+			auto const word = load64(data + index);
+			count += 8 - popcount(word & ~(word << 1) & bytes_of(0x80));
+		}
+#endif
+		for (; index < length; ++index) {
+			if (!is_continuation(data[index])) ++count;
+		}
+		return count;
+	}
+
+	/*
+	 * Number of code points in a well-formed UTF-16 buffer; every unit,
+	 * which is not a low surrogate, starts a new code point.
+	 */
+	inline std::size_t count_code_points(char16_t const* data,
+	                                      std::size_t length) noexcept {
+		std::size_t count = 0;
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const surrogate_mask = _mm_set1_epi16(static_cast<short>(0xFC00));
+		auto const low_surrogate = _mm_set1_epi16(static_cast<short>(0xDC00));
+		for (; index + 8 <= length; index += 8) {
+			auto const lows = _mm_cmpeq_epi16(
+			    _mm_and_si128(load(data + index), surrogate_mask),
+			    low_surrogate);
+			count += 8 - popcount(movemask16(lows));
+		}
+#elif defined(UTF_SIMD_SWAR)
+		// exact zero-lane test: no borrows leak between the lanes
+		auto const low_bits = units_of(0x7FFF);
+		for (; index + 4 <= length; index += 4) {
+			auto const lanes =
+			    (load64(data + index) & units_of(0xFC00)) ^ units_of(0xDC00);
+			auto const lows =
+			    ~(((lanes & low_bits) + low_bits) | lanes | low_bits);
+			count += 4 - popcount(lows);
+		}
+#endif
+		for (; index < length; ++index) {
+			if (!is_low_surrogate(data[index])) ++count;
+		}
+		return count;
+	}
+
+	/*
+	 * Length of a well-formed UTF-16 buffer in UTF-8: one byte per unit,
+	 * one more from U+0080 and another from U+0800 on; surrogates take two
+	 * bytes each, adding up to four for a pair.
+	 */
+	inline std::size_t utf8_length(char16_t const* data,
+	                               std::size_t length) noexcept {
+		std::size_t bytes = length;
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const zero = _mm_setzero_si128();
+		auto const last_ascii = _mm_set1_epi16(0x7F);
+		auto const last_two = _mm_set1_epi16(0x7FF);
+		auto const surrogate_mask = _mm_set1_epi16(static_cast<short>(0xF800));
+		auto const surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+		for (; index + 8 <= length; index += 8) {
+			auto const block = load(data + index);
+			auto const one = movemask16(
+			    _mm_cmpeq_epi16(_mm_subs_epu16(block, last_ascii), zero));
+			auto const up_to_two = movemask16(
+			    _mm_cmpeq_epi16(_mm_subs_epu16(block, last_two), zero));
+			auto const surrogates = movemask16(_mm_cmpeq_epi16(
+			    _mm_and_si128(block, surrogate_mask), surrogate));
+			bytes += 16 - popcount(one) - popcount(up_to_two) -
+			         popcount(surrogates);
+		}
+#elif defined(UTF_SIMD_SWAR)
+		// exact non-zero lane test, as in count_code_points
+		auto const low_bits = units_of(0x7FFF);
+		auto const non_zero = [low_bits](std::uint64_t lanes) {
+			return popcount((((lanes & low_bits) + low_bits) | lanes) &
+			                units_of(0x8000));
+		};
+		for (; index + 4 <= length; index += 4) {
+			auto const word = load64(data + index);
+			auto const high = word & units_of(0xF800);
+			// the last term counts the lanes which are not surrogates
+			bytes += non_zero(word & units_of(0xFF80)) + non_zero(high) +
+			         non_zero(high ^ units_of(0xD800));
+			bytes -= 4;
+		}
+#endif
+		for (; index < length; ++index) {
+			auto const unit = data[index];
+			if (unit >= 0xD800 && unit <= 0xDFFF)
+				bytes += 1;
+			else if (unit >= 0x800)
+				bytes += 2;
+			else if (unit >= 0x80)
+				bytes += 1;
+		}
+		return bytes;
+	}
+
+	/*
+	 * Number of lead bytes of four-byte sequences, i.e. of the code points
+	 * taking two units in UTF-16.
+	 */
+	inline std::size_t count_four_byte_leads(std::uint8_t const* data,
+	                                         std::size_t length) noexcept {
+		std::size_t count = 0;
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		// unsigned max(byte, F0) is the byte itself for F0-FF only
+		auto const first_lead = _mm_set1_epi8(static_cast<char>(0xF0));
+		for (; index + 16 <= length; index += 16) {
+			auto const block = load(data + index);
+			auto const leads =
+			    _mm_cmpeq_epi8(_mm_max_epu8(block, first_lead), block);
+			count += popcount(movemask8(leads));
+		}
+#elif defined(UTF_SIMD_SWAR)
+		// 1111xxxx: the four high bits set
+		for (; index + 8 <= length; index += 8) {
+			auto const word = load64(data + index);
+			count += popcount(word & (word << 1) & (word << 2) & (word << 3) &
+			                  bytes_of(0x80));
+		}
+#endif
+		for (; index < length; ++index) {
+			if (data[index] >= 0xF0) ++count;
+		}
+		return count;
+	}
+
+	/*
+	 * Index of the first line feed, or the length if there is none.
+	 */
+	inline std::size_t find_newline(std::uint8_t const* data,
+	                                std::size_t length) noexcept {
+		auto const found = std::memchr(data, '\n', length);
+		return found ? static_cast<std::size_t>(
+		                   static_cast<std::uint8_t const*>(found) - data)
+		             : length;
+	}
+
+	inline std::size_t find_newline(char16_t const* data,
+	                                std::size_t length) noexcept {
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const newline = _mm_set1_epi16('\n');
+		for (; index + 8 <= length; index += 8) {
+			auto const mask = movemask8(
+			    _mm_cmpeq_epi16(load(data + index), newline));
+			if (mask) return index + ctz(mask) / 2;
+		}
+#elif defined(UTF_SIMD_SWAR)
+		// exact zero-lane test, as in count_code_points
+		auto const low_bits = units_of(0x7FFF);
+		for (; index + 4 <= length; index += 4) {
+			auto const lanes = load64(data + index) ^ units_of(u'\n');
+			if (~(((lanes & low_bits) + low_bits) | lanes | low_bits)) break;
+		}
+#endif
+		while (index < length && data[index] != u'\n')
+			++index;
+		return index;
+	}
+
+	/*
+	 * Number of units well-formed UTF-8 decodes to: one for every byte,
+	 * which is not a continuation byte, and, with Pairs, one more for every
+	 * four-byte lead, which becomes a surrogate pair. Unlike the counters
+	 * above, the vector loop adds the byte masks up in lanes and folds them
+	 * only every 127 blocks, before a lane could overflow.
+	 */
+	template <bool Pairs>
+	inline std::size_t utf8_decoded_length(std::uint8_t const* data,
+	                                       std::size_t length) noexcept {
+		std::size_t count = 0;
+		std::size_t index = 0;
+#ifdef UTF_SIMD_SSE2
+		auto const zero = _mm_setzero_si128();
+		auto const last_continuation = _mm_set1_epi8(-65);
+		auto const first_lead = _mm_set1_epi8(static_cast<char>(0xF0));
+		while (index + 16 <= length) {
+			auto const blocks = std::min<std::size_t>((length - index) / 16, 127);
+			auto sums = zero;
+			for (std::size_t block = 0; block < blocks; ++block, index += 16) {
+				auto const bytes = load(data + index);
+				sums = _mm_sub_epi8(sums,
+				                    _mm_cmpgt_epi8(bytes, last_continuation));
+				if constexpr (Pairs)
+					sums = _mm_sub_epi8(
+					    sums, _mm_cmpeq_epi8(_mm_max_epu8(bytes, first_lead),
+					                         bytes));
+			}
+			auto const halves = _mm_sad_epu8(sums, zero);
+			count += static_cast<std::size_t>(_mm_cvtsi128_si32(halves)) +
+			         static_cast<std::size_t>(
+			             _mm_cvtsi128_si32(_mm_srli_si128(halves, 8)));
+		}
+#elif defined(UTF_SIMD_SWAR)
+		for (; index + 8 <= length; index += 8) {
+			auto const word = load64(data + index);
+			count += 8 - popcount(word & ~(word << 1) & bytes_of(0x80));
+			if constexpr (Pairs)
+				count += popcount(word & (word << 1) & (word << 2) &
+				                  (word << 3) & bytes_of(0x80));
+		}
+#endif
+		for (; index < length; ++index) {
+			if (!is_continuation(data[index])) ++count;
+			if (Pairs && data[index] >= 0xF0) ++count;
+		}
+		return count;
+	}
+
+	/*
+	 * Length of the longest UTF-8 sequence a lead byte in the buffer could
+	 * start: 1 for ASCII, 2 when no byte reaches E0, 3 when none reaches
+	 * F0, 4 otherwise. Stray continuation bytes count as 2; they are for
+	 * the decoder to reject.
+	 */
+	inline unsigned max_sequence_length(std::uint8_t const* data,
+	                                    std::size_t length) noexcept {
+		std::size_t index = 0;
+		unsigned result = 1;
+#ifdef UTF_SIMD_SSE2
+		if (length >= 16) {
+			auto top = _mm_setzero_si128();
+			for (; index + 16 <= length; index += 16)
+				top = _mm_max_epu8(top, load(data + index));
+			auto const reaches = [top](int limit) {
+				auto const below = _mm_cmpeq_epi8(
+				    _mm_subs_epu8(top, _mm_set1_epi8(static_cast<char>(limit))),
+				    _mm_setzero_si128());
+				return movemask8(below) != 0xFFFF;
+			};
+			result = reaches(0xEF)   ? 4
+			         : reaches(0xDF) ? 3
+			         : reaches(0x7F) ? 2
+			                         : 1;
+		}
+#elif defined(UTF_SIMD_SWAR)
+		std::uint64_t high{}, three{}, four{};
+		for (; index + 8 <= length; index += 8) {
+			auto const word = load64(data + index);
+			auto const leads = word & (word << 1) & (word << 2);
+			high |= word;
+			three |= leads;
+			four |= leads & (word << 3);
+		}
+		auto const top = bytes_of(0x80);
+		result = (four & top) ? 4 : (three & top) ? 3 : (high & top) ? 2 : 1;
+#endif
+		for (; index < length; ++index) {
+			auto const byte = data[index];
+			unsigned const width = byte < 0x80   ? 1
+			                       : byte < 0xE0 ? 2
+			                       : byte < 0xF0 ? 3
+			                                     : 4;
+			if (width > result) result = width;
+		}
+		return result;
+	}
+
+	/*
+	 * One bit per zero byte of the 16-byte block, the first byte in the
+	 * lowest bit.
+	 */
+	inline std::uint32_t zero_mask16(std::uint8_t const* block) noexcept {
+#ifdef UTF_SIMD_SSE2
+		return movemask8(_mm_cmpeq_epi8(load(block), _mm_setzero_si128()));
+#else
+		std::uint32_t mask = 0;
+		for (unsigned index = 0; index < 16; ++index) {
+			if (!block[index]) mask |= 1u << index;
+		}
+		return mask;
+#endif
+	}
+}  // namespace utf::detail
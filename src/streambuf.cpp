@@ -0,0 +1,253 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <cstring>
+#include <utf/streambuf.hpp>
+
+namespace utf {
+	namespace {
+		constexpr std::size_t min_block_size = 16;
+
+		std::size_t unit_size(encoding enc) noexcept {
+			switch (enc) {
+				case encoding::utf16le:
+				case encoding::utf16be:
+					return 2;
+				case encoding::utf32le:
+				case encoding::utf32be:
+					return 4;
+				default:
+					break;
+			}
+			return 1;
+		}
+
+		bool is_big_endian(encoding enc) noexcept {
+			return enc == encoding::utf16be || enc == encoding::utf32be;
+		}
+
+		template <typename Unit>
+		void load_units(char const* bytes,
+		                std::size_t count,
+		                bool big_endian,
+		                Unit* units) noexcept {
+			for (std::size_t index = 0; index < count; ++index) {
+				char32_t value = 0;
+				for (std::size_t byte = 0; byte < sizeof(Unit); ++byte) {
+					auto const at =
+					    big_endian ? byte : sizeof(Unit) - 1 - byte;
+					value = (value << 8) |
+					        static_cast<unsigned char>(bytes[at]);
+				}
+				units[index] = static_cast<Unit>(value);
+				bytes += sizeof(Unit);
+			}
+		}
+
+		template <typename Unit>
+		void store_units(Unit const* units,
+		                 std::size_t count,
+		                 bool big_endian,
+		                 char* bytes) noexcept {
+			for (std::size_t index = 0; index < count; ++index) {
+				auto value = static_cast<char32_t>(units[index]);
+				for (std::size_t byte = 0; byte < sizeof(Unit); ++byte) {
+					auto const at =
+					    big_endian ? sizeof(Unit) - 1 - byte : byte;
+					bytes[at] = static_cast<char>(value & 0xFF);
+					value >>= 8;
+				}
+				bytes += sizeof(Unit);
+			}
+		}
+
+		template <typename Unit>
+		transcode_result decode_units(char const* raw,
+		                              std::size_t raw_size,
+		                              bool big_endian,
+		                              std::basic_string<Unit>& scratch,
+		                              char* out,
+		                              std::size_t out_size,
+		                              on_error errors) {
+			auto const count = raw_size / sizeof(Unit);
+			scratch.resize(count);
+			load_units(raw, count, big_endian, scratch.data());
+			return transcode(std::basic_string_view<Unit>{scratch},
+			                 out, out_size, errors);
+		}
+	}  // namespace
+
+	transcoding_streambuf::transcoding_streambuf(std::streambuf* underlying,
+	                                             encoding external,
+	                                             on_error errors,
+	                                             std::size_t block_size)
+	    : underlying_{underlying}, external_{external}, errors_{errors} {
+		if (block_size < min_block_size) block_size = min_block_size;
+
+		get_area_.resize(block_size);
+		raw_in_.resize(block_size);
+		put_area_.resize(block_size);
+		raw_out_.resize(block_size * 4);
+		scratch16_.resize(block_size * 2);
+		scratch32_.resize(block_size);
+
+		setg(get_area_.data(), get_area_.data(), get_area_.data());
+		setp(put_area_.data(), put_area_.data() + put_area_.size());
+	}
+
+	transcoding_streambuf::~transcoding_streambuf() { finish(); }
+
+	bool transcoding_streambuf::finish() {
+		if (!encode_block(true)) return false;
+		return underlying_->pubsync() != -1;
+	}
+
+	transcoding_streambuf::int_type transcoding_streambuf::underflow() {
+		if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+		while (!failed_) {
+			if (raw_in_size_ && decode_block(eof_))
+				return traits_type::to_int_type(*gptr());
+			if (eof_) break;
+
+			auto const read = underlying_->sgetn(
+			    raw_in_.data() + raw_in_size_,
+			    static_cast<std::streamsize>(raw_in_.size() - raw_in_size_));
+			if (read <= 0)
+				eof_ = true;
+			else
+				raw_in_size_ += static_cast<std::size_t>(read);
+		}
+
+		return traits_type::eof();
+	}
+
+	transcoding_streambuf::int_type transcoding_streambuf::overflow(
+	    int_type ch) {
+		if (!encode_block(false)) return traits_type::eof();
+		if (traits_type::eq_int_type(ch, traits_type::eof()))
+			return traits_type::not_eof(ch);
+
+		// carry-over of a partial sequence never fills the whole put area
+		*pptr() = traits_type::to_char_type(ch);
+		pbump(1);
+		return ch;
+	}
+
+	int transcoding_streambuf::sync() {
+		if (!encode_block(false)) return -1;
+		return underlying_->pubsync();
+	}
+
+	std::size_t transcoding_streambuf::decode_block(bool final) {
+		auto const big_endian = is_big_endian(external_);
+		auto const out = get_area_.data();
+		auto const out_size = get_area_.size();
+
+		transcode_result result{};
+		switch (unit_size(external_)) {
+			case 2:
+				result = decode_units(raw_in_.data(), raw_in_size_, big_endian,
+				                      scratch16_, out, out_size, errors_);
+				break;
+			case 4:
+				result = decode_units(raw_in_.data(), raw_in_size_, big_endian,
+				                      scratch32_, out, out_size, errors_);
+				break;
+			default:
+				result =
+				    transcode(std::string_view{raw_in_.data(), raw_in_size_},
+				              out, out_size, errors_);
+				break;
+		}
+
+		auto consumed = result.read * unit_size(external_);
+		auto written = result.written;
+
+		if (result.status == transcode_status::invalid) failed_ = true;
+
+		auto const unfinished =
+		    result.status == transcode_status::incomplete ||
+		    (result.status == transcode_status::ok && consumed < raw_in_size_);
+		if (final && unfinished) {
+			if (errors_ == on_error::stop) {
+				failed_ = true;
+			} else if (out_size - written >= 3) {
+				std::memcpy(out + written, "\xEF\xBF\xBD", 3);
+				written += 3;
+				consumed = raw_in_size_;
+			}
+		}
+
+		std::memmove(raw_in_.data(), raw_in_.data() + consumed,
+		             raw_in_size_ - consumed);
+		raw_in_size_ -= consumed;
+
+		setg(out, out, out + written);
+		return written;
+	}
+
+	template <typename CharIn>
+	transcode_result transcoding_streambuf::emit(
+	    std::basic_string_view<CharIn> src) {
+		auto const big_endian = is_big_endian(external_);
+
+		transcode_result result{};
+		std::size_t bytes{};
+		switch (unit_size(external_)) {
+			case 2:
+				result = transcode(src, scratch16_.data(), scratch16_.size(),
+				                   errors_);
+				store_units(scratch16_.data(), result.written, big_endian,
+				            raw_out_.data());
+				bytes = result.written * 2;
+				break;
+			case 4:
+				result = transcode(src, scratch32_.data(), scratch32_.size(),
+				                   errors_);
+				store_units(scratch32_.data(), result.written, big_endian,
+				            raw_out_.data());
+				bytes = result.written * 4;
+				break;
+			default:
+				result =
+				    transcode(src, raw_out_.data(), raw_out_.size(), errors_);
+				bytes = result.written;
+				break;
+		}
+
+		auto const size = static_cast<std::streamsize>(bytes);
+		if (underlying_->sputn(raw_out_.data(), size) != size) failed_ = true;
+		if (result.status == transcode_status::invalid) failed_ = true;
+		return result;
+	}
+
+	bool transcoding_streambuf::encode_block(bool final) {
+		if (failed_) return false;
+
+		auto pending = std::string_view{
+		    pbase(), static_cast<std::size_t>(pptr() - pbase())};
+		while (!pending.empty()) {
+			auto const result = emit(pending);
+			if (failed_) return false;
+			pending.remove_prefix(result.read);
+			if (result.status == transcode_status::incomplete) break;
+		}
+
+		if (final && !pending.empty()) {
+			if (errors_ == on_error::stop) {
+				failed_ = true;
+				return false;
+			}
+			emit(std::u32string_view{U"\uFFFD"});
+			if (failed_) return false;
+			pending = {};
+		}
+
+		if (!pending.empty())
+			std::memmove(put_area_.data(), pending.data(), pending.size());
+		setp(put_area_.data(), put_area_.data() + put_area_.size());
+		pbump(static_cast<int>(pending.size()));
+		return true;
+	}
+}  // namespace utf
@@ -0,0 +1,141 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <algorithm>
+#include <mutex>
+#include <utf/text.hpp>
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		enum class form { utf8, utf16, utf32 };
+	}  // namespace
+
+	struct text::impl {
+		form original;
+		std::size_t code_points{};
+		bool ascii{};
+
+		std::string utf8;
+		std::u16string utf16;
+		std::u32string utf32;
+		std::once_flag utf8_once;
+		std::once_flag utf16_once;
+		std::once_flag utf32_once;
+
+		explicit impl(std::string&& src) : original{form::utf8} {
+			utf8 = std::move(src);
+			auto const bytes = reinterpret_cast<uint8_t const*>(utf8.data());
+			ascii = detail::ascii_prefix(bytes, utf8.size()) == utf8.size();
+			code_points = ascii ? utf8.size()
+			                    : detail::count_code_points(bytes, utf8.size());
+			std::call_once(utf8_once, [] {});
+		}
+
+		explicit impl(std::u16string&& src) : original{form::utf16} {
+			utf16 = std::move(src);
+			ascii = detail::ascii_prefix(utf16.data(), utf16.size()) ==
+			        utf16.size();
+			code_points =
+			    ascii ? utf16.size()
+			          : detail::count_code_points(utf16.data(), utf16.size());
+			std::call_once(utf16_once, [] {});
+		}
+
+		explicit impl(std::u32string&& src) : original{form::utf32} {
+			utf32 = std::move(src);
+			ascii = detail::ascii_prefix(utf32.data(), utf32.size()) ==
+			        utf32.size();
+			code_points = utf32.size();
+			std::call_once(utf32_once, [] {});
+		}
+
+		// ASCII text is only widened or narrowed, unit by unit
+		template <typename CharOut, typename CharIn>
+		static std::basic_string<CharOut> copy_ascii(
+		    std::basic_string<CharIn> const& src) {
+			std::basic_string<CharOut> out(src.size(), CharOut{});
+			if constexpr (sizeof(CharIn) == 1 && sizeof(CharOut) == 2) {
+				detail::widen_ascii(
+				    reinterpret_cast<uint8_t const*>(src.data()), src.size(),
+				    out.data());
+			} else if constexpr (sizeof(CharIn) == 2 && sizeof(CharOut) == 1) {
+				detail::narrow_ascii(src.data(), src.size(), out.data());
+			} else {
+				std::transform(src.begin(), src.end(), out.begin(),
+				               [](CharIn c) { return static_cast<CharOut>(c); });
+			}
+			return out;
+		}
+
+		template <typename CharOut>
+		std::basic_string<CharOut> convert() const {
+			switch (original) {
+				case form::utf8:
+					if (ascii) return copy_ascii<CharOut>(utf8);
+					break;
+				case form::utf16:
+					if (ascii) return copy_ascii<CharOut>(utf16);
+					break;
+				case form::utf32:
+					if (ascii) return copy_ascii<CharOut>(utf32);
+					break;
+			}
+
+			if constexpr (sizeof(CharOut) == 1) {
+				if (original == form::utf16) return as_str8(utf16);
+				return as_str8(utf32);
+			} else if constexpr (sizeof(CharOut) == 2) {
+				if (original == form::utf8) return as_u16(utf8);
+				return as_u16(utf32);
+			} else {
+				if (original == form::utf8) return as_u32(utf8);
+				return as_u32(utf16);
+			}
+		}
+	};
+
+	text::text(std::string_view src) {
+		if (!is_valid(src)) return;
+		impl_ = std::make_shared<impl>(std::string{src});
+	}
+
+	text::text(std::u16string_view src) {
+		if (!is_valid(src)) return;
+		impl_ = std::make_shared<impl>(std::u16string{src});
+	}
+
+	text::text(std::u32string_view src) {
+		if (!is_valid(src)) return;
+		impl_ = std::make_shared<impl>(std::u32string{src});
+	}
+
+	std::string_view text::str8() const {
+		if (!impl_) return {};
+		std::call_once(impl_->utf8_once,
+		               [this] { impl_->utf8 = impl_->convert<char>(); });
+		return impl_->utf8;
+	}
+
+	std::u16string_view text::u16() const {
+		if (!impl_) return {};
+		std::call_once(impl_->utf16_once,
+		               [this] { impl_->utf16 = impl_->convert<char16_t>(); });
+		return impl_->utf16;
+	}
+
+	std::u32string_view text::u32() const {
+		if (!impl_) return {};
+		std::call_once(impl_->utf32_once,
+		               [this] { impl_->utf32 = impl_->convert<char32_t>(); });
+		return impl_->utf32;
+	}
+
+	bool text::empty() const noexcept { return !impl_ || !impl_->code_points; }
+
+	std::size_t text::code_points() const noexcept {
+		return impl_ ? impl_->code_points : 0;
+	}
+
+	bool text::is_ascii() const noexcept { return !impl_ || impl_->ascii; }
+}  // namespace utf
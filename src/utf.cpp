@@ -42,433 +42,586 @@
 
 ------------------------------------------------------------------------ */
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <type_traits>
+#include <utf/convert.hpp>
 #include <utf/utf.hpp>
+#include "codec.hpp"
+#include "simd.hpp"
 
 namespace utf {
-	using std::uint8_t;
 	/*
-	 * Index into the table below with the first byte of a UTF-8 sequence to
-	 * get the number of trailing bytes that are supposed to follow it.
-	 * Note that *legal* UTF-8 values can't have 4 or 5-bytes. The table is
-	 * left as-is for anyone who may want to do such conversion, which was
-	 * allowed in earlier algorithms.
+	 * UTF-8 is validated with the DFA in blocks, checking for errors only
+	 * once per block; ASCII runs between sequences are skipped.
 	 */
-	static constexpr const uint8_t trailingBytesForUTF8[256] = {
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 00
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 10
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 20
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 30
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 40
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 50
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 60
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 70
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 80
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 90
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // A0
-	    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // B0
-	    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // C0
-	    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // D0
-	    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  // E0
-	    3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5   // F0
-	};
+	static inline bool is_valid_utf8(uint8_t const* bytes, std::size_t size) {
+		static constexpr std::size_t block_size = 64;
+		std::uint32_t state = detail::utf8_accept;
+		std::size_t pos = 0;
+		while (pos < size) {
+			if (state == detail::utf8_accept)
+				pos += detail::ascii_prefix(bytes + pos, size - pos);
+
+			auto const block_end =
+			    size - pos < block_size ? size : pos + block_size;
+			for (; pos < block_end; ++pos)
+				state = detail::utf8_step(state, bytes[pos]);
+			if (state == detail::utf8_reject) return false;
+		}
+		return state == detail::utf8_accept;
+	}
+
+	template <class StringView>
+	static inline bool is_valid_impl(StringView src) {
+		if constexpr (sizeof(src[0]) == 1) {
+			return is_valid_utf8(
+			    reinterpret_cast<uint8_t const*>(src.data()), src.size());
+		} else if constexpr (std::is_same_v<decltype(src[0]),
+		                                    char16_t const&>) {
+			return detail::utf16_invalid_offset(src.data(), src.size()) ==
+			       src.size();
+		} else if constexpr (std::is_same_v<decltype(src[0]),
+		                                    char32_t const&>) {
+			return detail::utf32_valid_prefix(src.data(), src.size()) ==
+			       src.size();
+		} else if constexpr (sizeof(src[0]) == 4) {
+			for (auto const unit : src) {
+				if (!detail::is_scalar_value(static_cast<char32_t>(unit)))
+					return false;
+			}
+			return true;
+		} else {
+			auto source = src.begin();
+			auto sourceEnd = src.end();
+
+			while (source < sourceEnd) {
+				bool ok = false;
+				[[maybe_unused]] char32_t ch = decode(source, sourceEnd, ok);
+				if (!ok) return false;
+			}
+
+			return true;
+		}
+	}
 
 	/*
-	 * Magic values subtracted from a buffer value during UTF8 conversion.
-	 * This table contains as many values as there might be trailing bytes
-	 * in a UTF-8 sequence.
+	 * Routines for the blocks of adaptive UTF-8 decoding. Each decodes the
+	 * sequences starting before block_end, reading up to end, and returns
+	 * false on an ill-formed one.
 	 */
-	static constexpr const char32_t offsetsFromUTF8[6] = {
-	    0x00000000UL, 0x00003080UL, 0x000E2080UL,
-	    0x03C82080UL, 0xFA082080UL, 0x82082080UL};
+	template <typename Char>
+	static inline void decode_ascii_block(uint8_t const*& src,
+	                                      uint8_t const* block_end,
+	                                      Char*& out) {
+		auto const length = static_cast<std::size_t>(block_end - src);
+		if constexpr (sizeof(Char) == 2) {
+			detail::widen_ascii(src, length, out);
+		} else {
+			for (std::size_t index = 0; index < length; ++index)
+				out[index] = src[index];
+		}
+		src = block_end;
+		out += length;
+	}
 
 	/*
-	 * Once the bits are split out into bytes of UTF-8, this is a mask OR-ed
-	 * into the first byte, depending on how many bytes follow.  There are
-	 * as many entries in this table as there are UTF-8 sequence types.
-	 * (I.e., one byte sequence, two byte... etc.). Remember that sequencs
-	 * for *legal* UTF-8 will be 4 or fewer bytes total.
+	 * Width is the longest sequence the block was found to start; leads
+	 * of longer ones are rejected without looking at them. Overlong forms,
+	 * surrogates and values past U+10FFFF are caught by the value.
 	 */
-	static constexpr const uint8_t firstByteMark[7] = {0x00, 0x00, 0xC0, 0xE0,
-	                                                   0xF0, 0xF8, 0xFC};
-
-	enum : char16_t {
-		UNI_SUR_HIGH_START = 0xD800,
-		UNI_SUR_HIGH_END = 0xDBFF,
-		UNI_SUR_LOW_START = 0xDC00,
-		UNI_SUR_LOW_END = 0xDFFF,
-	};
-
-	enum : char32_t {
-		UNI_REPLACEMENT_CHAR = 0x0000FFFD,
-		UNI_MAX_BMP = 0x0000FFFF,
-		UNI_MAX_UTF16 = 0x0010FFFF,
-		UNI_MAX_LEGAL_UTF32 = 0x0010FFFF
-	};
-
-	// used for shifting by 10 bits
-	static constexpr const unsigned halfShift = 10;
-
-	static constexpr const char32_t halfBase = 0x0001'0000UL;
-	static constexpr const char32_t halfMask = 0x3FFUL;
-	static constexpr const char32_t byteMask = 0xBF;
-	static constexpr const char32_t byteMark = 0x80;
-
-	template <typename T>
-	static bool isLegalUTF8(T source, int length) {
-		uint8_t a;
-		auto srcptr = source + length;
-		switch (length) {
-			default:
-				return false;
-				/* Everything else falls through when "true"... */
-			case 4:
-				if ((a = static_cast<uint8_t>(*--srcptr)) < 0x80 || a > 0xBF)
-					return false;
-				[[fallthrough]];
-			case 3:
-				if ((a = static_cast<uint8_t>(*--srcptr)) < 0x80 || a > 0xBF)
-					return false;
-				[[fallthrough]];
-			case 2:
-				if ((a = static_cast<uint8_t>(*--srcptr)) < 0x80 || a > 0xBF)
+	template <unsigned Width, typename Char>
+	static inline bool decode_block(uint8_t const*& src,
+	                                uint8_t const* block_end,
+	                                uint8_t const* end,
+	                                Char*& out) {
+		using detail::is_continuation;
+		while (src < block_end) {
+			auto const lead = *src;
+			if (lead < 0x80) {
+				*out++ = lead;
+				++src;
+				continue;
+			}
+
+			auto const available = end - src;
+			if (lead < 0xE0) {
+				if (lead < 0xC2 || available < 2 || !is_continuation(src[1]))
 					return false;
+				*out++ = static_cast<Char>(((lead & 0x1Fu) << 6) |
+				                           (src[1] & 0x3Fu));
+				src += 2;
+				continue;
+			}
 
-				switch (static_cast<uint8_t>(*source)) {
-						/* no fall-through in this inner switch */
-					case 0xE0:
-						if (a < 0xA0) return false;
-						break;
-					case 0xED:
-						if (a > 0x9F) return false;
-						break;
-					case 0xF0:
-						if (a < 0x90) return false;
-						break;
-					case 0xF4:
-						if (a > 0x8F) return false;
-						break;
-					default:
-						if (a < 0x80) return false;
+			if constexpr (Width >= 3) {
+				if (lead < 0xF0) {
+					if (available < 3 || !is_continuation(src[1]) ||
+					    !is_continuation(src[2]))
+						return false;
+					auto const ch = ((lead & 0x0Fu) << 12) |
+					                ((src[1] & 0x3Fu) << 6) |
+					                (src[2] & 0x3Fu);
+					if (ch < 0x800 || (ch >= UNI_SUR_HIGH_START &&
+					                   ch <= UNI_SUR_LOW_END))
+						return false;
+					*out++ = static_cast<Char>(ch);
+					src += 3;
+					continue;
 				}
-				[[fallthrough]];
+			}
 
-			case 1:
-				if (static_cast<uint8_t>(*source) >= 0x80 &&
-				    static_cast<uint8_t>(*source) < 0xC2)
-					return false;
+			if constexpr (Width == 4) {
+				if (lead <= 0xF4) {
+					if (available < 4 || !is_continuation(src[1]) ||
+					    !is_continuation(src[2]) || !is_continuation(src[3]))
+						return false;
+					char32_t const ch =
+					    ((lead & 0x07u) << 18) | ((src[1] & 0x3Fu) << 12) |
+					    ((src[2] & 0x3Fu) << 6) | (src[3] & 0x3Fu);
+					if (ch < halfBase || ch > UNI_MAX_LEGAL_UTF32)
+						return false;
+					out += encode_units(ch, out);
+					src += 4;
+					continue;
+				}
+			}
+
+			return false;
 		}
-		if (static_cast<uint8_t>(*source) > 0xF4) return false;
 		return true;
 	}
 
-	using str8_it = std::string_view::const_iterator;
-	static inline char32_t decode(str8_it& source,
-	                              str8_it sourceEnd,
-	                              bool& ok) {
-		ok = false;
-		auto const uchar = static_cast<uint8_t>(*source);
-		auto extraBytesToRead = trailingBytesForUTF8[uchar];
-		if (extraBytesToRead >= sourceEnd - source) return 0;
-
-		if (!isLegalUTF8(source, extraBytesToRead + 1)) return 0;
-
-		char32_t ch = 0;
-		/*
-		 * The cases all fall through.
-		 */
-		switch (extraBytesToRead) {
-			// 4 and 5 extra bytes are not passed through by isLegalUTF8
-			case 3:
-				ch += static_cast<uint8_t>(*source++);
-				ch <<= 6;
-				[[fallthrough]];
-			case 2:
-				ch += static_cast<uint8_t>(*source++);
-				ch <<= 6;
-				[[fallthrough]];
-			case 1:
-				ch += static_cast<uint8_t>(*source++);
-				ch <<= 6;
-				[[fallthrough]];
-			case 0:
-				ch += static_cast<uint8_t>(*source++);
-		}
-		ch -= offsetsFromUTF8[extraBytesToRead];
-		ok = true;
-		return ch;
+#ifdef __cpp_lib_string_resize_and_overwrite
+	template <class String>
+	static inline void resize_for_overwrite(String& out, std::size_t size) {
+		out.resize_and_overwrite(size, [](auto*, std::size_t n) { return n; });
 	}
+#endif
 
-#ifdef __cpp_lib_char8_t
-	using utf8_it = std::u8string_view::const_iterator;
-	static inline char32_t decode(utf8_it& source,
-	                              utf8_it sourceEnd,
-	                              bool& ok) {
-		ok = false;
-		auto const uchar = static_cast<uint8_t>(*source);
-		auto extraBytesToRead = trailingBytesForUTF8[uchar];
-		if (extraBytesToRead >= sourceEnd - source) return 0;
-
-		if (!isLegalUTF8(source, extraBytesToRead + 1)) return 0;
-
-		char32_t ch = 0;
-		/*
-		 * The cases all fall through.
-		 */
-		switch (extraBytesToRead) {
-			// 4 and 5 extra bytes are not passed through by isLegalUTF8
-			case 3:
-				ch += static_cast<uint8_t>(*source++);
-				ch <<= 6;
-				[[fallthrough]];
-			case 2:
-				ch += static_cast<uint8_t>(*source++);
-				ch <<= 6;
-				[[fallthrough]];
-			case 1:
-				ch += static_cast<uint8_t>(*source++);
-				ch <<= 6;
-				[[fallthrough]];
-			case 0:
-				ch += static_cast<uint8_t>(*source++);
-		}
-		ch -= offsetsFromUTF8[extraBytesToRead];
-		ok = true;
-		return ch;
+	/*
+	 * Number of units the UTF-8 takes in UTF-16 or UTF-32. Exact for
+	 * well-formed input; for ill-formed input it is still enough, as each
+	 * decoded code point starts at a byte counted here.
+	 */
+	template <typename Char>
+	static inline std::size_t decoded_length(std::string_view src) {
+		return detail::utf8_decoded_length<sizeof(Char) == 2>(
+		    reinterpret_cast<uint8_t const*>(src.data()), src.size());
 	}
-#endif  // __cpp_lib_char8_t
 
-	using utf16_it = std::u16string_view::const_iterator;
-	static inline char32_t decode(utf16_it& source,
-	                              utf16_it sourceEnd,
-	                              bool& ok) {
-		ok = true;
-		char32_t ch = *source++;
-		/* If we have a surrogate pair, convert to char32_t first. */
-		if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_HIGH_END) {
-			ok = false;
-			/* If the 16 bits following the high surrogate are in the source
-			 * buffer... */
-			if (source < sourceEnd) {
-				char32_t trail = *source;
-				/* If it's a low surrogate, convert to char32_t. */
-				if (trail >= UNI_SUR_LOW_START && trail <= UNI_SUR_LOW_END) {
-					ch = ((ch - UNI_SUR_HIGH_START) << halfShift) + trail -
-					     UNI_SUR_LOW_START + halfBase;
-					++source;
-					ok = true;
-				}
-			}
-		}
+	template <class String>
+	static inline String decode_adaptive(std::string_view src,
+	                                     block_profile* profile) {
+		using Char = typename String::value_type;
+		static constexpr std::ptrdiff_t block_size = 64;
 
-		return ch;
-	}
-
-	using utf32_it = std::u32string_view::const_iterator;
-	static inline char32_t decode(utf32_it& source,
-	                              utf32_it /* sourceEnd */,
-	                              bool& ok) {
-		ok = true;
-		return *source++;
-	}
-
-	static inline void encode(char32_t ch,
-	                          std::back_insert_iterator<std::string>& target) {
-		unsigned short bytesToWrite = 0;
-
-		/* Figure out how many bytes the result will require */
-		if (ch < 0x80u)
-			bytesToWrite = 1;
-		else if (ch < 0x800u)
-			bytesToWrite = 2;
-		else if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END) {
-			bytesToWrite = 3;
-			ch = UNI_REPLACEMENT_CHAR;
-		} else if (ch < 0x10000u)
-			bytesToWrite = 3;
-		else if (ch <= UNI_MAX_LEGAL_UTF32)
-			bytesToWrite = 4;
-		else {
-			bytesToWrite = 3;
-			ch = UNI_REPLACEMENT_CHAR;
+		auto const length = decoded_length<Char>(src);
+#ifdef __cpp_lib_string_resize_and_overwrite
+		String out;
+		resize_for_overwrite(out, length);
+#else
+		// the sized constructor fills much faster than resize() does
+		String out(length, Char{});
+#endif
+		auto const begin = out.data();
+		auto target = begin;
+
+		auto source = reinterpret_cast<uint8_t const*>(src.data());
+		auto const end = source + src.size();
+		block_profile counts{};
+		while (source < end) {
+			auto const block_end =
+			    end - source < block_size ? end : source + block_size;
+			auto ok = true;
+			switch (detail::max_sequence_length(
+			    source, static_cast<std::size_t>(block_end - source))) {
+				case 1:
+					++counts.ascii;
+					decode_ascii_block(source, block_end, target);
+					break;
+				case 2:
+					++counts.two_byte;
+					ok = decode_block<2>(source, block_end, end, target);
+					break;
+				case 3:
+					++counts.three_byte;
+					ok = decode_block<3>(source, block_end, end, target);
+					break;
+				default:
+					++counts.four_byte;
+					ok = decode_block<4>(source, block_end, end, target);
+					break;
+			}
+			if (!ok) return {};
 		}
 
-		uint8_t mid[4];
-		uint8_t* midp = mid + sizeof(mid);
-		switch (bytesToWrite) { /* note: everything falls through. */
-			case 4:
-				*--midp = static_cast<uint8_t>((ch | byteMark) & byteMask);
-				ch >>= 6;
-				[[fallthrough]];
-			case 3:
-				*--midp = static_cast<uint8_t>((ch | byteMark) & byteMask);
-				ch >>= 6;
-				[[fallthrough]];
-			case 2:
-				*--midp = static_cast<uint8_t>((ch | byteMark) & byteMask);
-				ch >>= 6;
-				[[fallthrough]];
-			case 1:
-				*--midp =
-				    static_cast<uint8_t>(ch | firstByteMark[bytesToWrite]);
+		if (profile) {
+			profile->ascii += counts.ascii;
+			profile->two_byte += counts.two_byte;
+			profile->three_byte += counts.three_byte;
+			profile->four_byte += counts.four_byte;
 		}
-		for (int i = 0; i < bytesToWrite; ++i)
-			*target++ = static_cast<char>(*midp++);
+		out.resize(static_cast<std::size_t>(target - begin));
+		return out;
 	}
 
-#ifdef __cpp_lib_char8_t
-	static inline void encode(
-	    char32_t ch,
-	    std::back_insert_iterator<std::u8string>& target) {
-		unsigned short bytesToWrite = 0;
-
-		/* Figure out how many bytes the result will require */
-		if (ch < 0x80u)
-			bytesToWrite = 1;
-		else if (ch < 0x800u)
-			bytesToWrite = 2;
-		else if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END) {
-			bytesToWrite = 3;
-			ch = UNI_REPLACEMENT_CHAR;
-		} else if (ch < 0x10000u)
-			bytesToWrite = 3;
-		else if (ch <= UNI_MAX_LEGAL_UTF32)
-			bytesToWrite = 4;
-		else {
-			bytesToWrite = 3;
-			ch = UNI_REPLACEMENT_CHAR;
-		}
+	// input size in bytes, from which conversions bypass the cache
+	static std::atomic<std::size_t> streaming_from{32 * 1024 * 1024};
+	static std::atomic<std::size_t> streamed{0};
 
-		uint8_t mid[4];
-		uint8_t* midp = mid + sizeof(mid);
-		switch (bytesToWrite) { /* note: everything falls through. */
-			case 4:
-				*--midp = static_cast<uint8_t>((ch | byteMark) & byteMask);
-				ch >>= 6;
-				[[fallthrough]];
-			case 3:
-				*--midp = static_cast<uint8_t>((ch | byteMark) & byteMask);
-				ch >>= 6;
-				[[fallthrough]];
-			case 2:
-				*--midp = static_cast<uint8_t>((ch | byteMark) & byteMask);
-				ch >>= 6;
-				[[fallthrough]];
-			case 1:
-				*--midp =
-				    static_cast<uint8_t>(ch | firstByteMark[bytesToWrite]);
+	template <typename Char>
+	static inline unsigned encode_checked(char32_t ch, Char* target) {
+		// as encode() does for the back inserter of std::u32string
+		if constexpr (std::is_same_v<Char, char32_t>) {
+			if (!detail::is_scalar_value(ch)) ch = UNI_REPLACEMENT_CHAR;
 		}
-		for (int i = 0; i < bytesToWrite; ++i)
-			*target++ = static_cast<char8_t>(*midp++);
+		return encode_units(ch, target);
 	}
-#endif  // __cpp_lib_char8_t
 
-	static inline void encode(
-	    char32_t ch,
-	    std::back_insert_iterator<std::u16string>& target) {
-		if (ch <= UNI_MAX_BMP) {
-			/* UTF-16 surrogate values are illegal in UTF-32 */
-			if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END) {
-				*target++ = UNI_REPLACEMENT_CHAR;
-				return;
+	/*
+	 * Converts the input through a small staging buffer, which stays in
+	 * L1, handing it to the flush in whole cache lines, and prefetching the
+	 * input line by line, a few lines ahead. Stops with false on ill-formed
+	 * input or when the flush refuses the units. Unchecked, UTF-32 values
+	 * out of range are passed through, as transcode() does.
+	 */
+	template <typename Char,
+	          bool Checked = true,
+	          class StringView,
+	          typename Flush>
+	static inline bool convert_staged(StringView src, Flush&& flush) {
+		static constexpr std::size_t cache_line = 64;
+		static constexpr std::size_t staging_size = 4096 / sizeof(Char);
+		static constexpr std::size_t line_units = cache_line / sizeof(Char);
+		static constexpr auto line_chars = static_cast<std::ptrdiff_t>(
+		    cache_line / sizeof(typename StringView::value_type));
+		static constexpr auto ahead = 8 * line_chars;
+
+		alignas(cache_line) Char staging[staging_size];
+		std::size_t filled = 0;
+
+		auto source = src.begin();
+		auto const sourceEnd = src.end();
+		auto prefetched = source;
+		while (source < sourceEnd) {
+			while (prefetched < sourceEnd && prefetched - source < ahead) {
+				detail::prefetch(&*prefetched);
+				prefetched += std::min(line_chars, sourceEnd - prefetched);
 			}
-			*target++ = static_cast<char16_t>(ch); /* normal case */
-			return;
-		}
 
-		if (ch > UNI_MAX_UTF16) {
-			*target++ = UNI_REPLACEMENT_CHAR;
-			return;
+			bool ok = false;
+			char32_t ch = decode(source, sourceEnd, ok);
+			if (!ok) return false;
+			if constexpr (Checked)
+				filled += encode_checked(ch, staging + filled);
+			else
+				filled += encode_units(ch, staging + filled);
+
+			if (staging_size - filled < 4) {
+				auto const lines = filled - filled % line_units;
+				if (!flush(static_cast<Char const*>(staging), lines))
+					return false;
+				std::copy(staging + lines, staging + filled, staging);
+				filled -= lines;
+			}
 		}
+		return flush(static_cast<Char const*>(staging), filled);
+	}
 
-		ch -= halfBase;
-		*target++ =
-		    static_cast<char16_t>((ch >> halfShift) + UNI_SUR_HIGH_START);
-		*target++ = static_cast<char16_t>((ch & halfMask) + UNI_SUR_LOW_START);
-	}
-
-	static inline void encode(
-	    char32_t ch,
-	    std::back_insert_iterator<std::u32string>& target) {
-		if constexpr (false) {
-			// This code will only have sense with some sort of UTF32-to-UTF32
-			// validation
-			if (ch <= UNI_MAX_LEGAL_UTF32) {
-				/*
-				 * UTF-16 surrogate values are illegal in UTF-32, and anything
-				 * over Plane 17 (> 0x10FFFF) is illegal.
-				 */
-				if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END) {
-					*target++ = UNI_REPLACEMENT_CHAR;
-					return;
-				}
-				*target++ = ch; /* normal case */
-				return;
-			}
-			*target++ = UNI_REPLACEMENT_CHAR;
-		} else
-			*target++ = ch; /* normal case */
+	/*
+	 * Length of the output, or npos for ill-formed input. UTF-16 going to
+	 * UTF-8 is measured with the vector kernels, anything else is converted
+	 * into the staging buffer and counted.
+	 */
+	template <typename Char, class StringView>
+	static inline std::size_t output_length(StringView src) {
+		using CharIn = typename StringView::value_type;
+		if constexpr (sizeof(Char) == 1 && sizeof(CharIn) == 2) {
+			// also a 16-bit wchar_t
+			auto const data = static_cast<char16_t const*>(
+			    static_cast<void const*>(src.data()));
+			if (detail::utf16_invalid_offset(data, src.size()) != src.size())
+				return npos;
+			return detail::utf8_length(data, src.size());
+		} else {
+			std::size_t length = 0;
+			auto const counted = convert_staged<Char>(
+			    src, [&](Char const*, std::size_t units) {
+				    length += units;
+				    return true;
+			    });
+			return counted ? length : npos;
+		}
 	}
 
-	template <class StringView>
-	static inline bool is_valid_impl(StringView src) {
-		auto source = src.begin();
-		auto sourceEnd = src.end();
+	/*
+	 * The output of a large input is sized by a first, read-only pass, so
+	 * the second one can stream the units to their place.
+	 */
+	template <class String, class StringView>
+	static inline String convert_large(StringView src) {
+		using Char = typename String::value_type;
 
-		while (source < sourceEnd) {
-			bool ok = false;
-			[[maybe_unused]] char32_t ch = decode(source, sourceEnd, ok);
-			if (!ok) return false;
-		}
+		auto const length = output_length<Char>(src);
+		if (length == npos) return {};
 
-		return true;
+		String out;
+		resize_for_overwrite(out, length);
+		auto target = out.data();
+		convert_staged<Char>(src, [&](Char const* units, std::size_t count) {
+			detail::stream_copy(target, units, count * sizeof(Char));
+			target += count;
+			return true;
+		});
+		detail::stream_fence();
+		streamed.fetch_add(1, std::memory_order_relaxed);
+		return out;
 	}
 
+	/*
+	 * Smaller inputs go through the header engine. Ill-formed UTF-8 and
+	 * UTF-16 give an empty string, while UTF-32 values out of range become
+	 * U+FFFD, as they do in the large conversions.
+	 */
 	template <class String, class StringView>
-	static inline String convert(StringView src) {
+	static inline String as_string(StringView src) {
+		using CharIn = typename StringView::value_type;
+		using Char = typename String::value_type;
+		using policy = std::conditional_t<sizeof(CharIn) == sizeof(char32_t),
+		                                  errors::replace, errors::strict>;
+
+#ifdef __cpp_lib_string_resize_and_overwrite
+		// without it, the string would be zero-filled before the streaming;
+		// transcode() streams into the memory of the caller instead
+		if (src.size() * sizeof(CharIn) >=
+		    streaming_from.load(std::memory_order_relaxed))
+			return convert_large<String>(src);
+#endif
+
 		String out;
+		if (convert<CharIn, Char, policy>(src, out).status !=
+		    transcode_status::ok)
+			return {};
+		return out;
+	}
+
+	/*
+	 * Streams well-formed input, which fits into the buffer, past the cache.
+	 * Anything else stops it and is converted again by transcode(), which
+	 * finds the exact place to stop at.
+	 */
+	template <typename CharOut, typename CharIn>
+	static inline bool transcode_large(std::basic_string_view<CharIn> src,
+	                                   CharOut* dst,
+	                                   std::size_t dst_size,
+	                                   std::size_t& written) {
+		written = 0;
+		auto const converted = convert_staged<CharOut, false>(
+		    src, [&](CharOut const* units, std::size_t count) {
+			    if (dst_size - written < count) return false;
+			    if (count)
+				    detail::stream_copy(dst + written, units,
+				                        count * sizeof(CharOut));
+			    written += count;
+			    return true;
+		    });
+		detail::stream_fence();
+		if (converted) streamed.fetch_add(1, std::memory_order_relaxed);
+		return converted;
+	}
+
+	template <typename CharOut, typename CharIn>
+	transcode_result transcode(std::basic_string_view<CharIn> src,
+	                           CharOut* dst,
+	                           std::size_t dst_size,
+	                           on_error errors) {
+		transcode_result result{};
+		if (src.size() * sizeof(CharIn) >=
+		        streaming_from.load(std::memory_order_relaxed) &&
+		    transcode_large(src, dst, dst_size, result.written)) {
+			result.read = src.size();
+			return result;
+		}
+		result.written = 0;
 		auto source = src.begin();
 		auto sourceEnd = src.end();
-		auto target = std::back_inserter(out);
 
 		while (source < sourceEnd) {
+			auto next = source;
 			bool ok = false;
-			char32_t ch = decode(source, sourceEnd, ok);
-			if (!ok) return {};
+			char32_t ch = decode(next, sourceEnd, ok);
+			if (!ok) {
+				if (is_truncated(source, sourceEnd)) {
+					result.status = transcode_status::incomplete;
+					break;
+				}
+				if (errors == on_error::stop) {
+					result.status = transcode_status::invalid;
+					break;
+				}
+				ch = UNI_REPLACEMENT_CHAR;
+				next = source + invalid_length(source, sourceEnd);
+			}
 
-			encode(ch, target);
+			CharOut units[4];
+			auto const length = encode_units(ch, units);
+			if (dst_size - result.written < length) {
+				result.status = transcode_status::output_full;
+				break;
+			}
+			for (unsigned i = 0; i < length; ++i)
+				dst[result.written++] = units[i];
+			source = next;
 		}
 
-		return out;
+		result.read = static_cast<std::size_t>(source - src.begin());
+		return result;
 	}
 
+#define UTF_TRANSCODE_FROM(CharIn)                                         \
+	template transcode_result transcode<char, CharIn>(                     \
+	    std::basic_string_view<CharIn>, char*, std::size_t, on_error);     \
+	template transcode_result transcode<char16_t, CharIn>(                 \
+	    std::basic_string_view<CharIn>, char16_t*, std::size_t, on_error); \
+	template transcode_result transcode<char32_t, CharIn>(                 \
+	    std::basic_string_view<CharIn>, char32_t*, std::size_t, on_error); \
+	template transcode_result transcode<wchar_t, CharIn>(                  \
+	    std::basic_string_view<CharIn>, wchar_t*, std::size_t, on_error);  \
+	UTF_TRANSCODE_FROM_U8(CharIn)
+
+#ifdef __cpp_lib_char8_t
+#define UTF_TRANSCODE_FROM_U8(CharIn)                 \
+	template transcode_result transcode<char8_t, CharIn>( \
+	    std::basic_string_view<CharIn>, char8_t*, std::size_t, on_error);
+#else
+#define UTF_TRANSCODE_FROM_U8(CharIn)
+#endif
+
+	UTF_TRANSCODE_FROM(char)
+	UTF_TRANSCODE_FROM(char16_t)
+	UTF_TRANSCODE_FROM(char32_t)
+	UTF_TRANSCODE_FROM(wchar_t)
+#ifdef __cpp_lib_char8_t
+	UTF_TRANSCODE_FROM(char8_t)
+#endif
+
+#undef UTF_TRANSCODE_FROM
+#undef UTF_TRANSCODE_FROM_U8
+
 	bool is_valid(std::string_view src) { return is_valid_impl(src); }
 	bool is_valid(std::u16string_view src) { return is_valid_impl(src); }
-	bool is_valid(std::u32string_view) { return true; }
+	bool is_valid(std::u32string_view src) { return is_valid_impl(src); }
+
+	std::u32string sanitize(std::u32string_view src) {
+		std::u32string out{src};
+		auto const data = out.data();
+		auto const size = out.size();
+		std::size_t pos = 0;
+		while ((pos += detail::utf32_valid_prefix(data + pos, size - pos)) <
+		       size)
+			data[pos++] = UNI_REPLACEMENT_CHAR;
+		return out;
+	}
+
+	void set_streaming_threshold(std::size_t bytes) noexcept {
+		streaming_from.store(bytes, std::memory_order_relaxed);
+	}
+
+	std::size_t streaming_threshold() noexcept {
+		return streaming_from.load(std::memory_order_relaxed);
+	}
+
+	std::size_t streamed_conversions() noexcept {
+		return streamed.load(std::memory_order_relaxed);
+	}
 
 	std::u16string as_u16(std::string_view src) {
-		return convert<std::u16string>(src);
+		return decode_adaptive<std::u16string>(src, nullptr);
 	}
 
 	std::u32string as_u32(std::string_view src) {
-		return convert<std::u32string>(src);
+		return decode_adaptive<std::u32string>(src, nullptr);
+	}
+
+	std::u16string as_u16(std::string_view src, block_profile& profile) {
+		return decode_adaptive<std::u16string>(src, &profile);
+	}
+
+	std::u32string as_u32(std::string_view src, block_profile& profile) {
+		return decode_adaptive<std::u32string>(src, &profile);
 	}
 
 	std::string as_str8(std::u16string_view src) {
-		return convert<std::string>(src);
+		return as_string<std::string>(src);
 	}
 
 	std::u32string as_u32(std::u16string_view src) {
-		return convert<std::u32string>(src);
+		return as_string<std::u32string>(src);
 	}
 
 	std::string as_str8(std::u32string_view src) {
-		return convert<std::string>(src);
+		return as_string<std::string>(src);
 	}
 
 	std::u16string as_u16(std::u32string_view src) {
-		return convert<std::u16string>(src);
+		return as_string<std::u16string>(src);
+	}
+
+	/*
+	 * Same-width conversion between wchar_t and char16_t/char32_t: copy the
+	 * units as they are, without reinterpreting one string type as another.
+	 */
+	template <typename CharOut, typename CharIn>
+	static std::basic_string<CharOut> copy_units(
+	    std::basic_string_view<CharIn> src) {
+		static_assert(
+		    sizeof(CharOut) == sizeof(CharIn),
+		    "This function only works for strings of same-sized characters.");
+		std::basic_string<CharOut> out(src.size(), CharOut{});
+		if (!src.empty())
+			std::memcpy(out.data(), src.data(), src.size() * sizeof(CharIn));
+		return out;
+	}
+
+	bool is_valid(std::wstring_view src) { return is_valid_impl(src); }
+
+	std::wstring as_wstring(std::string_view src) {
+		return as_string<std::wstring>(src);
+	}
+
+	std::wstring as_wstring(std::u16string_view src) {
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+			return copy_units<wchar_t>(src);
+		else
+			return as_string<std::wstring>(src);
+	}
+
+	std::wstring as_wstring(std::u32string_view src) {
+		if constexpr (sizeof(wchar_t) == sizeof(char32_t))
+			return copy_units<wchar_t>(src);
+		else
+			return as_string<std::wstring>(src);
+	}
+
+	std::string as_str8(std::wstring_view src) {
+		return as_string<std::string>(src);
+	}
+
+	std::u16string as_u16(std::wstring_view src) {
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+			return copy_units<char16_t>(src);
+		else
+			return as_string<std::u16string>(src);
+	}
+
+	std::u32string as_u32(std::wstring_view src) {
+		if constexpr (sizeof(wchar_t) == sizeof(char32_t))
+			return copy_units<char32_t>(src);
+		else
+			return as_string<std::u32string>(src);
 	}
 
 #ifdef __cpp_lib_char8_t
@@ -485,23 +638,31 @@ namespace utf {
 	std::string as_str8(std::u8string_view src) { return char_conv<char>(src); }
 
 	std::u16string as_u16(std::u8string_view src) {
-		return convert<std::u16string>(src);
+		return decode_adaptive<std::u16string>(as_str8_view(src), nullptr);
 	}
 
 	std::u32string as_u32(std::u8string_view src) {
-		return convert<std::u32string>(src);
+		return decode_adaptive<std::u32string>(as_str8_view(src), nullptr);
 	}
 
 	std::u8string as_u8(std::u16string_view src) {
-		return convert<std::u8string>(src);
+		return as_string<std::u8string>(src);
 	}
 
 	std::u8string as_u8(std::u32string_view src) {
-		return convert<std::u8string>(src);
+		return as_string<std::u8string>(src);
 	}
 
 	std::u8string as_u8(std::string_view src) {
 		return char_conv<char8_t>(src);
 	}
+
+	std::wstring as_wstring(std::u8string_view src) {
+		return as_string<std::wstring>(src);
+	}
+
+	std::u8string as_u8(std::wstring_view src) {
+		return as_string<std::u8string>(src);
+	}
 #endif  // __cpp_lib_char8_t
 }  // namespace utf
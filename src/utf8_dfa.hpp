@@ -0,0 +1,110 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace utf::detail {
+	/*
+	 * Shift-based DFA for well-formed UTF-8. Each table entry holds the next
+	 * state for every current state in 6-bit fields, indexed by the state
+	 * itself, so a step is a load, a shift and a mask, without branching on
+	 * the byte. The top byte of an entry is the mask of the payload bits for
+	 * a lead byte.
+	 */
+	enum : std::uint32_t {
+		utf8_accept = 0,
+		utf8_reject = 6,
+	};
+
+	namespace dfa {
+		enum state : unsigned {
+			accept,
+			reject,
+			tail1,    // one continuation byte to go
+			tail2,    // two continuation bytes to go
+			tail3,    // three continuation bytes to go
+			after_e0, // A0..BF, then one more
+			after_ed, // 80..9F, then one more
+			after_f0, // 90..BF, then two more
+			after_f4, // 80..8F, then two more
+			state_count
+		};
+
+		constexpr state next(state current, unsigned byte) noexcept {
+			auto const continuation = byte >= 0x80 && byte <= 0xBF;
+			switch (current) {
+				case accept:
+					if (byte < 0x80) return accept;
+					if (byte >= 0xC2 && byte <= 0xDF) return tail1;
+					if (byte == 0xE0) return after_e0;
+					if (byte == 0xED) return after_ed;
+					if (byte >= 0xE1 && byte <= 0xEF) return tail2;
+					if (byte == 0xF0) return after_f0;
+					if (byte == 0xF4) return after_f4;
+					if (byte >= 0xF1 && byte <= 0xF3) return tail3;
+					return reject;
+				case tail1:
+					return continuation ? accept : reject;
+				case tail2:
+					return continuation ? tail1 : reject;
+				case tail3:
+					return continuation ? tail2 : reject;
+				case after_e0:
+					return byte >= 0xA0 && byte <= 0xBF ? tail1 : reject;
+				case after_ed:
+					return byte >= 0x80 && byte <= 0x9F ? tail1 : reject;
+				case after_f0:
+					return byte >= 0x90 && byte <= 0xBF ? tail2 : reject;
+				case after_f4:
+					return byte >= 0x80 && byte <= 0x8F ? tail2 : reject;
+				default:
+					break;
+			}
+			return reject;
+		}
+
+		constexpr std::uint64_t payload_mask(unsigned byte) noexcept {
+			if (byte < 0x80) return 0x7F;
+			if (byte < 0xE0) return 0x1F;
+			if (byte < 0xF0) return 0x0F;
+			return 0x07;
+		}
+
+		constexpr std::array<std::uint64_t, 256> make_table() noexcept {
+			std::array<std::uint64_t, 256> table{};
+			for (unsigned byte = 0; byte < 256; ++byte) {
+				std::uint64_t entry = payload_mask(byte) << 56;
+				for (unsigned from = 0; from < state_count; ++from) {
+					auto const to = next(static_cast<state>(from), byte);
+					entry |= std::uint64_t{to * 6u} << (from * 6u);
+				}
+				table[byte] = entry;
+			}
+			return table;
+		}
+	}  // namespace dfa
+
+	inline constexpr std::array<std::uint64_t, 256> utf8_dfa =
+	    dfa::make_table();
+
+	inline std::uint32_t utf8_step(std::uint32_t state,
+	                               std::uint8_t byte) noexcept {
+		return static_cast<std::uint32_t>(utf8_dfa[byte] >> state) & 63;
+	}
+
+	/*
+	 * Same step, accumulating the code point: a lead byte contributes its
+	 * payload bits, a continuation byte six more bits.
+	 */
+	inline std::uint32_t utf8_step(std::uint32_t state,
+	                               char32_t& ch,
+	                               std::uint8_t byte) noexcept {
+		auto const entry = utf8_dfa[byte];
+		auto const mask = static_cast<char32_t>(
+		    state == utf8_accept ? entry >> 56 : 0x3F);
+		ch = (state == utf8_accept ? 0 : ch << 6) | (byte & mask);
+		return static_cast<std::uint32_t>(entry >> state) & 63;
+	}
+}  // namespace utf::detail
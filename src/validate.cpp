@@ -0,0 +1,149 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utf/utf.hpp>
+#include <vector>
+#include "codec.hpp"
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		constexpr std::size_t block_size = 64;
+		// how often a worker looks for an earlier error found by another one
+		constexpr std::size_t cancel_check = 64 * 1024;
+		constexpr std::size_t min_slice = 1024 * 1024;
+
+		/*
+		 * Runs the DFA in blocks, as is_valid does, remembering the last
+		 * block boundary, where no sequence was open. The sequences from
+		 * there are decoded one by one, once the DFA rejects the input, to
+		 * find the offset of the ill-formed one.
+		 */
+		template <typename Cancelled>
+		std::size_t invalid_offset_in(std::string_view src,
+		                              Cancelled cancelled) {
+			auto const bytes = reinterpret_cast<uint8_t const*>(src.data());
+			auto const size = src.size();
+
+			std::uint32_t state = detail::utf8_accept;
+			std::size_t pos = 0;
+			std::size_t checkpoint = 0;
+			std::size_t next_check = cancel_check;
+			while (pos < size) {
+				if (state == detail::utf8_accept) {
+					pos += detail::ascii_prefix(bytes + pos, size - pos);
+					checkpoint = pos;
+				}
+
+				auto const block_end =
+				    size - pos < block_size ? size : pos + block_size;
+				for (; pos < block_end; ++pos)
+					state = detail::utf8_step(state, bytes[pos]);
+				if (state == detail::utf8_reject) break;
+
+				if (pos >= next_check) {
+					if (cancelled()) return npos;
+					next_check = pos + cancel_check;
+				}
+			}
+
+			if (state == detail::utf8_accept) return npos;
+
+			auto source = src.begin() + static_cast<std::ptrdiff_t>(checkpoint);
+			auto const sourceEnd = src.end();
+			while (source < sourceEnd) {
+				bool ok = false;
+				[[maybe_unused]] auto const ch = decode(source, sourceEnd, ok);
+				if (!ok) break;
+			}
+			return static_cast<std::size_t>(source - src.begin());
+		}
+
+		/*
+		 * Moves the split forward past the continuation bytes, so no
+		 * well-formed sequence is cut in two. More than three of them
+		 * cannot be well-formed, so the slice before the split reports an
+		 * earlier error anyway.
+		 */
+		std::size_t slice_start(std::string_view src, std::size_t pos) {
+			auto const bytes = reinterpret_cast<uint8_t const*>(src.data());
+			for (int step = 0; step < 3 && pos < src.size(); ++step, ++pos) {
+				if (!detail::is_continuation(bytes[pos])) break;
+			}
+			return pos;
+		}
+	}  // namespace
+
+	std::size_t invalid_offset(std::string_view src, unsigned threads) {
+		if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+		auto const slices = std::min<std::size_t>(
+		    threads, std::max<std::size_t>(1, src.size() / min_slice));
+		if (slices < 2) return invalid_offset_in(src, [] { return false; });
+
+		std::vector<std::size_t> bounds(slices + 1);
+		for (std::size_t index = 1; index < slices; ++index)
+			bounds[index] = slice_start(src, src.size() / slices * index);
+		bounds[slices] = src.size();
+
+		// the lowest offset of an error found so far
+		std::atomic<std::size_t> first_error{npos};
+
+		auto const worker = [&](std::size_t index) {
+			auto const begin = bounds[index];
+			auto const end = std::max(begin, bounds[index + 1]);
+			// an error before this slice makes the rest of it irrelevant
+			auto const cancelled = [&] {
+				return first_error.load(std::memory_order_relaxed) < begin;
+			};
+			auto const local =
+			    invalid_offset_in(src.substr(begin, end - begin), cancelled);
+			if (local == npos) return;
+
+			auto const offset = begin + local;
+			auto current = first_error.load(std::memory_order_relaxed);
+			while (offset < current &&
+			       !first_error.compare_exchange_weak(
+			           current, offset, std::memory_order_relaxed)) {
+			}
+		};
+
+		std::vector<std::thread> workers;
+		workers.reserve(slices - 1);
+		std::size_t started = 1;
+		try {
+			for (; started < slices; ++started)
+				workers.emplace_back(worker, started);
+		} catch (...) {
+			// out of threads; the slices left are validated below
+		}
+
+		try {
+			worker(0);
+			for (auto index = started; index < slices; ++index)
+				worker(index);
+		} catch (...) {
+			for (auto& thread : workers)
+				thread.join();
+			throw;
+		}
+		for (auto& thread : workers)
+			thread.join();
+
+		return first_error.load();
+	}
+
+	std::size_t invalid_offset(std::u16string_view src) {
+		auto const offset =
+		    detail::utf16_invalid_offset(src.data(), src.size());
+		return offset == src.size() ? npos : offset;
+	}
+
+#ifdef __cpp_lib_char8_t
+	std::size_t invalid_offset(std::u8string_view src, unsigned threads) {
+		return invalid_offset(as_str8_view(src), threads);
+	}
+#endif
+}  // namespace utf
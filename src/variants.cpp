@@ -0,0 +1,230 @@
+// Copyright (c) 2026 midnightBITS
+// This code is licensed under MIT license (see LICENSE for details)
+
+#include <algorithm>
+#include <utf/utf.hpp>
+#include "codec.hpp"
+#include "simd.hpp"
+
+namespace utf {
+	namespace {
+		// the vector kernel for the size of the unit
+		template <typename Char>
+		std::size_t ascii_prefix(Char const* data, std::size_t length) {
+			if constexpr (sizeof(Char) == 1)
+				return detail::ascii_prefix(
+				    reinterpret_cast<uint8_t const*>(data), length);
+			else
+				return detail::ascii_prefix(data, length);
+		}
+
+		/*
+		 * Length of the ASCII run at the start of the input, which may be
+		 * copied as-is; in modified UTF-8, U+0000 is not one of them. There,
+		 * the run is scanned a block at a time, so the scan ends near the
+		 * first NUL instead of going over the rest of the run again for
+		 * every NUL in it.
+		 */
+		template <typename Char>
+		std::size_t plain_prefix(std::basic_string_view<Char> src,
+		                         utf8_variant variant) noexcept {
+			if (variant != utf8_variant::mutf8)
+				return ascii_prefix(src.data(), src.size());
+
+			static constexpr std::size_t block_size = 64;
+			std::size_t length = 0;
+			while (length < src.size()) {
+				auto const block =
+				    std::min(block_size, src.size() - length);
+				auto const run = src.substr(
+				    length, ascii_prefix(src.data() + length, block));
+				auto const nul = run.find(Char{0});
+				if (nul != run.npos) return length + nul;
+				length += run.size();
+				if (run.size() < block) break;
+			}
+			return length;
+		}
+
+		template <typename Char>
+		void append_ascii(std::basic_string<Char>& out, std::string_view run) {
+			auto const offset = out.size();
+			out.resize(offset + run.size());
+			auto const target = out.data() + offset;
+			if constexpr (sizeof(Char) == 1)
+				std::copy(run.begin(), run.end(), target);
+			else if constexpr (sizeof(Char) == 2)
+				detail::widen_ascii(
+				    reinterpret_cast<uint8_t const*>(run.data()), run.size(),
+				    target);
+			else
+				std::transform(run.begin(), run.end(), target,
+				               [](char c) { return static_cast<Char>(c); });
+		}
+
+		/*
+		 * Unpaired surrogates read from a relative of UTF-8 are kept in
+		 * UTF-16 and UTF-32, so they round-trip.
+		 */
+		template <typename Unit>
+		unsigned encode_lossless(char32_t ch, Unit* target) {
+			if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_LOW_END) {
+				*target = static_cast<Unit>(ch);
+				return 1;
+			}
+			return encode_units(ch, target);
+		}
+
+		/*
+		 * The ASCII runs are judged by the plain variant, so U+0000 is
+		 * never copied as-is, when either side is modified UTF-8.
+		 */
+		template <typename String, typename Encoder>
+		String decode_all(std::string_view src,
+		                  utf8_variant variant,
+		                  Encoder encoder,
+		                  utf8_variant plain) {
+			String out;
+			out.reserve(src.size());
+
+			auto source = src.begin();
+			auto const sourceEnd = src.end();
+			while (source < sourceEnd) {
+				auto const rest = src.substr(
+				    static_cast<std::size_t>(source - src.begin()));
+				auto const run = rest.substr(0, plain_prefix(rest, plain));
+				if (!run.empty()) {
+					append_ascii(out, run);
+					source += static_cast<std::ptrdiff_t>(run.size());
+					continue;
+				}
+
+				bool ok = false;
+				auto const ch = decode_variant(source, sourceEnd, variant, ok);
+				if (!ok) return {};
+
+				typename String::value_type units[6];
+				auto const length = encoder(ch, units);
+				if (!length) return {};
+				out.append(units, length);
+			}
+
+			return out;
+		}
+
+		template <typename Char>
+		std::string encode_all(std::basic_string_view<Char> src,
+		                       utf8_variant variant) {
+			std::string out;
+			out.reserve(src.size());
+
+			// only WTF-8 and modified UTF-8 keep unpaired surrogates
+			auto const lossless = variant == utf8_variant::wtf8 ||
+			                      variant == utf8_variant::mutf8;
+
+			auto source = src.begin();
+			auto const sourceEnd = src.end();
+			while (source < sourceEnd) {
+				auto const offset =
+				    static_cast<std::size_t>(source - src.begin());
+				auto const run_length =
+				    plain_prefix(src.substr(offset), variant);
+				if (run_length) {
+					auto const start = out.size();
+					out.resize(start + run_length);
+					if constexpr (sizeof(Char) == 2)
+						detail::narrow_ascii(src.data() + offset, run_length,
+						                     out.data() + start);
+					else
+						std::transform(
+						    source,
+						    source + static_cast<std::ptrdiff_t>(run_length),
+						    out.data() + start,
+						    [](Char c) { return static_cast<char>(c); });
+					source += static_cast<std::ptrdiff_t>(run_length);
+					continue;
+				}
+
+				char32_t ch{};
+				if constexpr (sizeof(Char) == 2) {
+					bool ok = false;
+					ch = decode_utf16(source, sourceEnd, ok);
+					if (!ok && !lossless) return {};
+				} else {
+					ch = *source++;
+					// a pair of surrogate values is joined, as it would be in
+					// UTF-16
+					if (lossless && ch >= UNI_SUR_HIGH_START &&
+					    ch <= UNI_SUR_HIGH_END && source < sourceEnd &&
+					    *source >= UNI_SUR_LOW_START &&
+					    *source <= UNI_SUR_LOW_END) {
+						ch = ((ch - UNI_SUR_HIGH_START) << halfShift) +
+						     *source++ - UNI_SUR_LOW_START + halfBase;
+					}
+				}
+
+				char units[6];
+				auto const length = encode_variant(ch, units, variant);
+				if (!length) return {};
+				out.append(units, length);
+			}
+
+			return out;
+		}
+	}  // namespace
+
+	bool is_valid(std::string_view src, utf8_variant variant) {
+		if (variant == utf8_variant::strict) return is_valid(src);
+
+		auto source = src.begin();
+		auto const sourceEnd = src.end();
+		while (source < sourceEnd) {
+			auto const rest =
+			    src.substr(static_cast<std::size_t>(source - src.begin()));
+			if (auto const run = plain_prefix(rest, variant)) {
+				source += static_cast<std::ptrdiff_t>(run);
+				continue;
+			}
+
+			bool ok = false;
+			[[maybe_unused]] auto const ch =
+			    decode_variant(source, sourceEnd, variant, ok);
+			if (!ok) return false;
+		}
+		return true;
+	}
+
+	std::u16string as_u16(std::string_view src, utf8_variant variant) {
+		return decode_all<std::u16string>(
+		    src, variant, encode_lossless<char16_t>, variant);
+	}
+
+	std::u32string as_u32(std::string_view src, utf8_variant variant) {
+		return decode_all<std::u32string>(
+		    src, variant, encode_lossless<char32_t>, variant);
+	}
+
+	std::string as_str8(std::u16string_view src, utf8_variant variant) {
+		return encode_all(src, variant);
+	}
+
+	std::string as_str8(std::u32string_view src, utf8_variant variant) {
+		return encode_all(src, variant);
+	}
+
+	std::string as_str8(std::string_view src,
+	                    utf8_variant from,
+	                    utf8_variant to) {
+		if (from == to) {
+			if (!is_valid(src, from)) return {};
+			return std::string{src};
+		}
+		auto const plain = to == utf8_variant::mutf8 ? to : from;
+		return decode_all<std::string>(
+		    src, from,
+		    [to](char32_t ch, char* target) {
+			    return encode_variant(ch, target, to);
+		    },
+		    plain);
+	}
+}  // namespace utf
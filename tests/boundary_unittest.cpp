@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <utf/utf.hpp>
+#include <vector>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(boundary, utf8_floor) {
+		// a, ą (2), € (3), 😀 (4), b
+		auto const text = "a\xc4\x85\xe2\x82\xac\xf0\x9f\x98\x80"
+		                  "b"sv;
+		size_t const expected[] = {0, 1, 1, 3, 3, 3, 6, 6, 6, 6, 10, 11, 11};
+		for (size_t units = 0; units < std::size(expected); ++units)
+			EXPECT_EQ(expected[units], floor_boundary(text, units))
+			    << "units: " << units;
+	}
+
+	TEST(boundary, utf8_ceil) {
+		auto const text = "a\xc4\x85\xe2\x82\xac"sv;
+		size_t const expected[] = {0, 1, 3, 3, 6, 6, 6, 6};
+		for (size_t units = 0; units < std::size(expected); ++units)
+			EXPECT_EQ(expected[units], ceil_boundary(text, units))
+			    << "units: " << units;
+	}
+
+	TEST(boundary, past_the_end) {
+		EXPECT_EQ(3u, ceil_boundary("abc"sv, 3));
+		EXPECT_EQ(3u, ceil_boundary("abc"sv, 10));
+		EXPECT_EQ(3u, ceil_boundary(u"abc"sv, 3));
+		EXPECT_EQ(3u, ceil_boundary(u"abc"sv, 10));
+		EXPECT_EQ(3u, ceil_boundary(U"abc"sv, 3));
+		EXPECT_EQ(3u, ceil_boundary(U"abc"sv, 10));
+		EXPECT_EQ(0u, ceil_boundary(""sv, 1));
+
+		// the view ends right before a lead byte, which is not looked at
+		auto const text = "abÄ"sv;
+		EXPECT_EQ(2u, ceil_boundary(text.substr(0, 2), 2));
+		EXPECT_EQ(2u, ceil_boundary(text.substr(0, 2), 10));
+		EXPECT_EQ(2u, floor_boundary(text.substr(0, 2), 10));
+		auto const wide = u"ab😀"sv;
+		EXPECT_EQ(2u, ceil_boundary(wide.substr(0, 2), 10));
+	}
+
+	TEST(boundary, utf8_stray_continuation) {
+		auto const text = "a\x80\x80\x80\x80"
+		                  "b"sv;
+		EXPECT_EQ(2u, floor_boundary(text, 2));
+		EXPECT_EQ(4u, floor_boundary(text, 4));
+	}
+
+	TEST(boundary, utf8_truncate) {
+		auto const text = "zażółć"sv;
+		EXPECT_EQ("za"sv, truncate_to_units(text, 3));
+		EXPECT_EQ("zaż"sv, truncate_to_units(text, 4));
+		EXPECT_EQ(text, truncate_to_units(text, 100));
+		EXPECT_TRUE(is_valid(truncate_to_units(text, 7)));
+	}
+
+	TEST(boundary, utf16) {
+		auto const text = u"a\U0001F600b"sv;
+		EXPECT_EQ(1u, floor_boundary(text, 1));
+		EXPECT_EQ(1u, floor_boundary(text, 2));
+		EXPECT_EQ(3u, floor_boundary(text, 3));
+		EXPECT_EQ(3u, ceil_boundary(text, 2));
+		EXPECT_EQ(u"a"sv, truncate_to_units(text, 2));
+		// lone low surrogate is not glued to its predecessor
+		EXPECT_EQ(1u, floor_boundary(u"a\xDC00"sv, 1));
+	}
+
+	TEST(boundary, utf32) {
+		EXPECT_EQ(2u, floor_boundary(U"abc"sv, 2));
+		EXPECT_EQ(3u, floor_boundary(U"abc"sv, 5));
+		EXPECT_EQ(U"ab"sv, truncate_to_units(U"abc"sv, 2));
+	}
+
+	template <typename Char>
+	std::vector<std::basic_string_view<Char>> split(
+	    chunk_range<Char> const& range) {
+		return {range.begin(), range.end()};
+	}
+
+	TEST(boundary, chunks) {
+		auto const text = "ab€€cd"sv;
+		auto const actual = split(chunks(text, 4));
+		std::vector const expected = {"ab"sv, "€"sv, "€c"sv, "d"sv};
+		EXPECT_EQ(expected, actual);
+	}
+
+	TEST(boundary, chunks_too_small) {
+		auto const text = "€a"sv;
+		auto const actual = split(chunks(text, 2));
+		std::vector const expected = {"€"sv, "a"sv};
+		EXPECT_EQ(expected, actual);
+	}
+
+	TEST(boundary, chunks_utf16) {
+		auto const text = u"a\U0001F600\U0001F600"sv;
+		auto const actual = split(chunks(text, 2));
+		std::vector const expected = {u"a"sv, u"\U0001F600"sv,
+		                              u"\U0001F600"sv};
+		EXPECT_EQ(expected, actual);
+		EXPECT_TRUE(split(chunks(u""sv, 2)).empty());
+	}
+}  // namespace utf::testing
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <utf/cache.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(cache, shared_results) {
+		conversion_cache cache;
+		auto const first = cache.as_u16("zażółć"sv);
+		auto const second = cache.as_u16(std::string{"zażółć"});
+		ASSERT_TRUE(first);
+		EXPECT_EQ(u"zażółć"sv, *first);
+		EXPECT_EQ(first.get(), second.get());
+		EXPECT_EQ(1u, cache.size());
+
+		EXPECT_TRUE(cache.as_u16("ab\xC4"sv)->empty());
+		EXPECT_EQ(2u, cache.size());
+	}
+
+	TEST(cache, bounded) {
+		conversion_cache cache{8, 2};
+		auto const kept = cache.as_u16("kept"sv);
+		for (int index = 0; index < 100; ++index)
+			cache.as_u16(std::to_string(index));
+		EXPECT_LE(cache.size(), 8u);
+
+		// evicted results stay alive for their owners
+		EXPECT_EQ(u"kept"sv, *kept);
+
+		cache.clear();
+		EXPECT_EQ(0u, cache.size());
+	}
+
+	TEST(cache, uneven_shards) {
+		conversion_cache cache{8, 3};
+		EXPECT_EQ(8u, cache.capacity());
+		for (int index = 0; index < 1000; ++index)
+			cache.as_u16(std::to_string(index));
+		EXPECT_LE(cache.size(), 8u);
+
+		conversion_cache empty{0};
+		EXPECT_EQ(1u, empty.capacity());
+		empty.as_u16("a"sv);
+		empty.as_u16("b"sv);
+		EXPECT_EQ(1u, empty.size());
+	}
+
+	TEST(cache, second_chance) {
+		conversion_cache cache{4, 1};
+		auto const hot = cache.as_u16("hot"sv);
+		for (int index = 0; index < 20; ++index) {
+			EXPECT_EQ(hot.get(), cache.as_u16("hot"sv).get());
+			cache.as_u16(std::to_string(index));
+		}
+	}
+
+	TEST(cache, threads) {
+		conversion_cache cache{64, 4};
+		std::vector<std::thread> threads;
+		for (int thread = 0; thread < 8; ++thread) {
+			threads.emplace_back([&cache] {
+				for (int index = 0; index < 2000; ++index) {
+					auto const key = "key-ą-" + std::to_string(index % 100);
+					auto const value = cache.as_u16(key);
+					ASSERT_EQ(as_u16(key), *value);
+				}
+			});
+		}
+		for (auto& thread : threads)
+			thread.join();
+		EXPECT_LE(cache.size(), 64u);
+	}
+}  // namespace utf::testing
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <utf/codepage.hpp>
+#include <utf/utf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	struct codepage_test {
+		codepage page;
+		std::string_view bytes;
+		std::u16string_view text;
+	};
+
+	constexpr codepage_test codepage_tests[] = {
+	    {codepage::iso8859_1, "Gr\xFC\xDF Gott \xA9 \xBD"sv,
+	     u"Grüß Gott © ½"sv},
+	    {codepage::iso8859_2, "Za\xBF\xF3\xB3\xE6 g\xEA\xB6l\xB1 ja\xBC\xF1"sv,
+	     u"Zażółć gęślą jaźń"sv},
+	    {codepage::iso8859_5, "\xDF\xE0\xD8\xD2\xD5\xE2 \xF0"sv,
+	     u"привет №"sv},
+	    {codepage::iso8859_15, "\xA4 \xBC\xBD"sv, u"€ Œœ"sv},
+	    {codepage::windows1250,
+	     "Za\xBF\xF3\xB3\xE6 g\xEA\x9Cl\xB9 ja\x9F\xF1"sv,
+	     u"Zażółć gęślą jaźń"sv},
+	    {codepage::windows1251, "\xEF\xF0\xE8\xE2\xE5\xF2 \xB9"sv,
+	     u"привет №"sv},
+	    {codepage::windows1252, "\x80 \x93quoted\x94 \x85"sv,
+	     u"€ “quoted” …"sv},
+	    {codepage::koi8_r, "\xD0\xD2\xC9\xD7\xC5\xD4 \xF0\xF2\xe9"sv,
+	     u"привет ПРИ"sv},
+	};
+
+	TEST(codepage, decode) {
+		for (auto const& test : codepage_tests) {
+			EXPECT_EQ(test.text, as_u16(test.bytes, test.page));
+			EXPECT_EQ(as_str8(test.text), as_str8(test.bytes, test.page));
+			EXPECT_EQ(as_u32(test.text), as_u32(test.bytes, test.page));
+		}
+	}
+
+	TEST(codepage, encode) {
+		for (auto const& test : codepage_tests) {
+			EXPECT_EQ(test.bytes, as_codepage(test.text, test.page));
+			EXPECT_EQ(test.bytes, as_codepage(as_str8(test.text), test.page));
+			EXPECT_EQ(test.bytes, as_codepage(as_u32(test.text), test.page));
+		}
+	}
+
+	TEST(codepage, round_trip) {
+		std::string all;
+		for (unsigned byte = 0; byte < 256; ++byte)
+			all.push_back(static_cast<char>(byte));
+
+		for (auto const page :
+		     {codepage::iso8859_1, codepage::iso8859_2, codepage::iso8859_5,
+		      codepage::iso8859_15, codepage::windows1250,
+		      codepage::windows1251, codepage::windows1252,
+		      codepage::koi8_r}) {
+			auto const text = as_u16(all, page);
+			ASSERT_EQ(256u, text.size());
+			EXPECT_EQ(all, as_codepage(text, page));
+		}
+	}
+
+	TEST(codepage, undefined_bytes) {
+		// web browsers read the holes of Windows-1252 as C1 controls
+		EXPECT_EQ(u"\u0081\u008D\u008F\u0090\u009D"sv,
+		          as_u16("\x81\x8D\x8F\x90\x9D"sv, codepage::windows1252));
+	}
+
+	TEST(codepage, long_ascii) {
+		auto const ascii = std::string(100, 'x');
+		auto const bytes = ascii + "\xE9" + ascii;
+		auto const text = std::u16string(100, u'x') + u"é" +
+		                  std::u16string(100, u'x');
+		EXPECT_EQ(text, as_u16(bytes, codepage::windows1252));
+		EXPECT_EQ(bytes, as_codepage(text, codepage::windows1252));
+	}
+
+	TEST(codepage, unmappable) {
+		EXPECT_EQ(""sv, as_codepage(u"a€b"sv, codepage::iso8859_1));
+		EXPECT_EQ(""sv, as_codepage(u"ą"sv, codepage::windows1252));
+		EXPECT_EQ(""sv, as_codepage(U"\U0001F600"sv, codepage::windows1252));
+		EXPECT_EQ(""sv, as_codepage(u"a\xD800"sv, codepage::iso8859_1));
+		EXPECT_EQ(""sv, as_codepage("a\xC0\x80"sv, codepage::iso8859_1));
+		EXPECT_EQ(""sv, as_codepage(U"\x110000"sv, codepage::iso8859_1));
+		EXPECT_EQ("\0"sv, as_codepage(U"\0"sv, codepage::koi8_r));
+	}
+
+#ifdef __cpp_lib_char8_t
+	TEST(codepage, u8) {
+		EXPECT_EQ("Zażółć"sv, as_str8_view(as_u8("Za\xBF\xF3\xB3\xE6"sv,
+		                                         codepage::iso8859_2)));
+		EXPECT_EQ("Za\xBF\xF3\xB3\xE6"sv,
+		          as_codepage(u8"Zażółć"sv, codepage::iso8859_2));
+	}
+#endif
+}  // namespace utf::testing
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <deque>
+#include <utf/convert.hpp>
+#include <utility>
+#include <vector>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	// a fixed-capacity ring, keeping the last units written
+	template <typename Char, std::size_t Size>
+	struct ring {
+		std::array<Char, Size> units{};
+		std::size_t next{};
+
+		void push_back(Char unit) { units[next++ % Size] = unit; }
+	};
+
+	TEST(convert, containers) {
+		auto const text = "zażółć \U0001F600"sv;
+
+		std::u16string str;
+		auto result = convert<char, char16_t>(text, str);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(text.size(), result.read);
+		EXPECT_EQ(u"zażółć \U0001F600"s, str);
+		EXPECT_EQ(str.size(), result.written);
+
+		std::vector<char32_t> vec;
+		convert<char16_t, char32_t>(str, vec);
+		EXPECT_EQ(U"zażółć \U0001F600"sv,
+		          std::u32string_view(vec.data(), vec.size()));
+
+		std::deque<char> deque;
+		convert<char32_t, char>(U"ó\U0001F600"sv, deque);
+		EXPECT_EQ("ó\U0001F600"s, std::string(deque.begin(), deque.end()));
+
+		ring<char, 4> last;
+		result = convert<char16_t, char>(u"abcó"sv, last);
+		EXPECT_EQ(5u, result.written);
+		EXPECT_EQ(5u, last.next);
+		EXPECT_EQ('\xB3', last.units[0]);
+	}
+
+	TEST(convert, same_width) {
+		std::string out;
+		EXPECT_EQ(transcode_status::ok,
+		          (convert<char, char>("zażółć"sv, out)).status);
+		EXPECT_EQ("zażółć"sv, out);
+
+		out.clear();
+		auto const bad = "ab\xe2\x8f-"sv;
+		auto const result = convert<char, char>(bad, out);
+		EXPECT_EQ(transcode_status::invalid, result.status);
+		EXPECT_EQ(2u, result.read);
+		EXPECT_EQ("ab"sv, out);
+
+#ifdef __cpp_lib_char8_t
+		std::u8string u8;
+		convert<char, char8_t>("zażółć"sv, u8);
+		EXPECT_EQ(u8"zażółć"sv, u8);
+#endif
+	}
+
+	TEST(convert, fixed_buffer) {
+		auto const src = u"zażółć \U0001F600"sv;
+		char block[5];
+		auto result = convert<char16_t, char>(src, span_sink{block});
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_EQ(3u, result.read);
+		EXPECT_EQ(4u, result.written);
+		EXPECT_EQ("za\xc5\xbc"sv, std::string_view(block, result.written));
+
+		std::string out;
+		for (auto rest = src; !rest.empty();) {
+			span_sink sink{block};
+			result = convert<char16_t, char>(rest, sink);
+			EXPECT_EQ(result.written, sink.size());
+			out += sink.view();
+			rest.remove_prefix(result.read);
+		}
+		EXPECT_EQ(as_str8(src), out);
+
+		// a long ASCII run, refused by the sink in the middle of a block
+		std::array<char16_t, 100> array;
+		auto const ascii = std::string(150, 'a');
+		result = convert<char, char16_t>(ascii, span_sink{array});
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_EQ(100u, result.read);
+		EXPECT_EQ(100u, result.written);
+	}
+
+	TEST(convert, policies) {
+		auto const invalid = "ab\xe2\x8f-\xff-\xe2\x8f"sv;
+
+		std::u16string out;
+		auto result = convert<char, char16_t>(invalid, out);
+		EXPECT_EQ(transcode_status::invalid, result.status);
+		EXPECT_EQ(2u, result.read);
+		EXPECT_EQ(u"ab"sv, out);
+
+		out.clear();
+		result = convert<char, char16_t>(invalid.substr(0, 4), out);
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+		EXPECT_EQ(2u, result.read);
+
+		out.clear();
+		result = convert<char, char16_t>(invalid, out, errors::replace{});
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(invalid.size(), result.read);
+		EXPECT_EQ(u"ab\uFFFD-\uFFFD-\uFFFD"sv, out);
+
+		out.clear();
+		convert<char, char16_t>(invalid, out, errors::skip{});
+		EXPECT_EQ(u"ab--"sv, out);
+
+		std::vector<std::pair<std::size_t, std::size_t>> found;
+		out.clear();
+		result = convert<char, char16_t>(
+		    invalid, out,
+		    errors::report{[&](std::size_t offset, std::size_t length) {
+			    found.emplace_back(offset, length);
+		    }});
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(u"ab--"sv, out);
+		std::vector<std::pair<std::size_t, std::size_t>> const expected{
+		    {2, 2}, {5, 1}, {7, 2}};
+		EXPECT_EQ(expected, found);
+	}
+
+	TEST(convert, surrogates) {
+		std::string out;
+		auto result = convert<char16_t, char>(u"a\xDC00-"sv, out);
+		EXPECT_EQ(transcode_status::invalid, result.status);
+		EXPECT_EQ(1u, result.read);
+
+		out.clear();
+		result = convert<char16_t, char>(u"a\xD800"sv, out);
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+
+		out.clear();
+		convert<char32_t, char>(U"a\xD800\x110000-"sv, out, errors::replace{});
+		EXPECT_EQ("a\xef\xbf\xbd\xef\xbf\xbd-"sv, out);
+
+		// every error is reported once, even if a block is taken back
+		char block[8];
+		std::size_t errors_seen = 0;
+		auto const text = U"abcdef\xD800gh"sv;
+		result = convert<char32_t, char>(
+		    text, span_sink{block},
+		    errors::report{[&](std::size_t, std::size_t) { ++errors_seen; }});
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(1u, errors_seen);
+		EXPECT_EQ("abcdefgh"sv, std::string_view(block, result.written));
+	}
+
+	TEST(convert, long_input) {
+		std::u32string text;
+		for (char32_t ch = 0; ch < 0x11000; ++ch) {
+			if (ch >= 0xD800 && ch <= 0xDFFF) continue;
+			text.push_back(ch);
+		}
+
+		std::string utf8;
+		EXPECT_EQ(transcode_status::ok,
+		          (convert<char32_t, char>(text, utf8)).status);
+		std::u16string utf16;
+		EXPECT_EQ(transcode_status::ok,
+		          (convert<char, char16_t>(utf8, utf16)).status);
+		std::u32string back;
+		EXPECT_EQ(transcode_status::ok,
+		          (convert<char16_t, char32_t>(utf16, back)).status);
+		EXPECT_EQ(text, back);
+		EXPECT_EQ(as_u16(text), utf16);
+	}
+}  // namespace utf::testing
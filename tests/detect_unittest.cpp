@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <utf/detect.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	detect_result detect_bytes(std::string_view bytes) {
+		return detect(reinterpret_cast<std::byte const*>(bytes.data()),
+		              bytes.size());
+	}
+
+	template <typename Char>
+	std::string bytes_of(std::basic_string_view<Char> text, bool big_endian) {
+		std::string result;
+		for (auto ch : text) {
+			auto const value = static_cast<std::uint32_t>(ch);
+			for (std::size_t byte = 0; byte < sizeof(Char); ++byte) {
+				auto const shift =
+				    big_endian ? (sizeof(Char) - 1 - byte) * 8 : byte * 8;
+				result.push_back(static_cast<char>((value >> shift) & 0xFF));
+			}
+		}
+		return result;
+	}
+
+	TEST(detect, empty) {
+		auto const result = detect_bytes({});
+		EXPECT_EQ(encoding::utf8, result.guess);
+		EXPECT_EQ(0.0, result.confidence);
+		EXPECT_EQ(0u, result.bom_size);
+	}
+
+	TEST(detect, boms) {
+		struct {
+			std::string_view bytes;
+			encoding enc;
+			std::size_t bom_size;
+		} const tests[] = {
+		    {"\xEF\xBB\xBFzażółć"sv, encoding::utf8, 3},
+		    {"\xFF\xFEz\0a\0"sv, encoding::utf16le, 2},
+		    {"\xFE\xFF\0z\0a"sv, encoding::utf16be, 2},
+		    {"\xFF\xFE\0\0z\0\0\0"sv, encoding::utf32le, 4},
+		    {"\0\0\xFE\xFF\0\0\0z"sv, encoding::utf32be, 4},
+		    {"\xFF\xFE\0\0"sv, encoding::utf32le, 4},
+		};
+		for (auto const& test : tests) {
+			auto const result = detect_bytes(test.bytes);
+			EXPECT_EQ(test.enc, result.guess);
+			EXPECT_EQ(1.0, result.confidence);
+			EXPECT_EQ(test.bom_size, result.bom_size);
+		}
+	}
+
+	TEST(detect, bom_with_bad_text) {
+		auto const result = detect_bytes("\xEF\xBB\xBFza\xC0\x80"sv);
+		EXPECT_EQ(encoding::utf8, result.guess);
+		EXPECT_LT(result.confidence, 1.0);
+		EXPECT_EQ(3u, result.bom_size);
+	}
+
+	TEST(detect, without_bom) {
+		auto const text =
+		    U"Zażółć gęślą jaźń, Съешь же ещё этих мягких французских булок "
+		    U"\U0001F600 and some more plain text to fill the buffer."sv;
+		auto const utf16 = as_u16(text);
+
+		struct {
+			std::string bytes;
+			encoding enc;
+		} const tests[] = {
+		    {as_str8(text), encoding::utf8},
+		    {bytes_of(std::u16string_view{utf16}, false), encoding::utf16le},
+		    {bytes_of(std::u16string_view{utf16}, true), encoding::utf16be},
+		    {bytes_of(text, false), encoding::utf32le},
+		    {bytes_of(text, true), encoding::utf32be},
+		};
+		for (auto const& test : tests) {
+			auto const result = detect_bytes(test.bytes);
+			EXPECT_EQ(test.enc, result.guess) << static_cast<int>(test.enc);
+			EXPECT_GT(result.confidence, 0.5) << static_cast<int>(test.enc);
+			EXPECT_EQ(0u, result.bom_size);
+		}
+	}
+
+	TEST(detect, truncated) {
+		// a file prefix may end in the middle of a character
+		auto text = std::string(40, 'a') + "\xC5\xBC\xE2\x82"s;
+		auto result = detect_bytes(text);
+		EXPECT_EQ(encoding::utf8, result.guess);
+		EXPECT_EQ(1.0, result.confidence);
+
+		text = bytes_of(u"abcdefgh\U0001F600"sv, false);
+		text.pop_back();
+		text.pop_back();
+		text.pop_back();
+		result = detect_bytes(text);
+		EXPECT_EQ(encoding::utf16le, result.guess);
+	}
+
+	TEST(detect, binary) {
+		std::string bytes;
+		for (unsigned index = 0; index < 256; ++index)
+			bytes.push_back(static_cast<char>(index * 37 + 11));
+		auto const result = detect_bytes(bytes);
+		EXPECT_LT(result.confidence, 0.75);
+	}
+}  // namespace utf::testing
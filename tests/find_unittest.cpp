@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <utf/utf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(find, empty) {
+		EXPECT_FALSE(find(""sv, U'a'));
+		auto const found = find("abc"sv, ""sv);
+		ASSERT_TRUE(found);
+		EXPECT_EQ(0u, found.units);
+		EXPECT_EQ(0u, found.code_points);
+	}
+
+	TEST(find, ascii) {
+		auto const found = find("key=value"sv, U'=');
+		ASSERT_TRUE(found);
+		EXPECT_EQ(3u, found.units);
+		EXPECT_EQ(3u, found.code_points);
+		EXPECT_FALSE(find("key=value"sv, U';'));
+	}
+
+	TEST(find, utf8_code_point) {
+		auto const text = "zażółć gęślą jaźń € \U0001F600!"s;
+		auto found = find(text, U'€');
+		ASSERT_TRUE(found);
+		EXPECT_EQ(text.find("€"), found.units);
+		EXPECT_EQ(18u, found.code_points);
+
+		found = find(text, U'\U0001F600');
+		ASSERT_TRUE(found);
+		EXPECT_EQ(text.find("\U0001F600"), found.units);
+		EXPECT_EQ(20u, found.code_points);
+	}
+
+	TEST(find, utf8_substring) {
+		auto const text = "ŧĥê qũïçķ Ƌȓôŵñ ƒôx ĵũmpş ôvêȓ ȧ ĺȧȥÿ đôğ"s;
+		auto const found = find(text, "ĵũmpş"sv);
+		ASSERT_TRUE(found);
+		EXPECT_EQ(text.find("ĵũmpş"), found.units);
+		EXPECT_EQ(20u, found.code_points);
+		EXPECT_FALSE(find(text, "ĵũmps"sv));
+	}
+
+	TEST(find, utf8_long) {
+		std::string text(1000, 'a');
+		text += "ą€b";
+		text.append(100, 'c');
+		auto const found = find(text, "€b"sv);
+		ASSERT_TRUE(found);
+		EXPECT_EQ(1002u, found.units);
+		EXPECT_EQ(1001u, found.code_points);
+
+		auto const last = find(text, U'c');
+		ASSERT_TRUE(last);
+		EXPECT_EQ(1006u, last.units);
+		EXPECT_EQ(1003u, last.code_points);
+	}
+
+	TEST(find, ill_formed_needle) {
+		auto const text = "\xe2\x82\xac\xe2\x82\xac"sv;
+		EXPECT_FALSE(find(text, "\x82\xac"sv));
+		EXPECT_FALSE(find(text, "\xe2\x82"sv));
+		EXPECT_FALSE(find(text, static_cast<char32_t>(0xD800)));
+		EXPECT_FALSE(find(text, static_cast<char32_t>(0x110000)));
+	}
+
+	TEST(find, utf16) {
+		std::u16string text(40, u'x');
+		text += u"\U0001F600y\U0001F600z";
+		auto found = find(text, U'z');
+		ASSERT_TRUE(found);
+		EXPECT_EQ(45u, found.units);
+		EXPECT_EQ(43u, found.code_points);
+
+		found = find(text, u"y\U0001F600"sv);
+		ASSERT_TRUE(found);
+		EXPECT_EQ(42u, found.units);
+		EXPECT_EQ(41u, found.code_points);
+
+		// a lone low surrogate is not a valid needle
+		EXPECT_FALSE(find(text, u"\xDE00"sv));
+	}
+
+	TEST(find, utf32) {
+		auto const text = U"ab\U0001F600cd"sv;
+		auto const found = find(text, U"cd"sv);
+		ASSERT_TRUE(found);
+		EXPECT_EQ(3u, found.units);
+		EXPECT_EQ(3u, found.code_points);
+	}
+
+#ifdef __cpp_lib_char8_t
+	TEST(find, u8) {
+		auto const found = find(u8"dwa złote"sv, U'ł');
+		ASSERT_TRUE(found);
+		EXPECT_EQ(5u, found.units);
+		EXPECT_EQ(5u, found.code_points);
+	}
+#endif
+}  // namespace utf::testing
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <utf/format.hpp>
+
+#ifdef __cpp_lib_format
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(format, utf16) {
+		EXPECT_EQ("[zażółć]"s, std::format("[{}]", formatted(u"zażółć"sv)));
+	}
+
+	TEST(format, utf32) {
+		EXPECT_EQ("€ \U0001F600"s,
+		          std::format("{}", formatted(U"€ \U0001F600"sv)));
+	}
+
+	TEST(format, long_input) {
+		std::u16string input(1000, u'ą');
+		auto const expected = as_str8(input);
+		EXPECT_EQ(expected, std::format("{}", formatted(input)));
+	}
+
+	TEST(format, lossy) {
+		auto const input = u"ab\xD800"s;
+		EXPECT_EQ("ab\xEF\xBF\xBD"s, std::format("{}", formatted(input)));
+		EXPECT_EQ("ab\xEF\xBF\xBD"s, std::format("{:l}", formatted(input)));
+	}
+
+	TEST(format, strict) {
+		auto const input = formatted(u"ab\xD800"sv);
+		EXPECT_THROW((void)std::vformat("{:s}", std::make_format_args(input)),
+		             std::format_error);
+		EXPECT_EQ("abc"s, std::format("{:s}", formatted(u"abc"sv)));
+	}
+}  // namespace utf::testing
+#endif
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <utf/graphemes.hpp>
+#include <utf/utf.hpp>
+#include <vector>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	struct grapheme_case {
+		std::u32string_view text;
+		std::vector<std::size_t> lengths;  // in code points
+	};
+
+	static grapheme_case const cases[] = {
+	    {U""sv, {}},
+	    {U"abc"sv, {1, 1, 1}},
+	    // GB3, GB4, GB5
+	    {U"a\r\nb"sv, {1, 2, 1}},
+	    {U"\n\r"sv, {1, 1}},
+	    {U"\r\u0301"sv, {1, 1}},
+	    {U"\u0001\u0301"sv, {1, 1}},
+	    // GB6, GB7, GB8: jamo and syllables
+	    {U"\u1100\u1161\u11A8"sv, {3}},
+	    {U"\uAC00\u11A8\uAC01\u11A8"sv, {2, 2}},
+	    {U"\uAC01\u1161"sv, {1, 1}},
+	    {U"\u1100\uAC00\u1100"sv, {2, 1}},
+	    // GB9, GB9a, GB9b
+	    {U"e\u0301\u0302x"sv, {3, 1}},
+	    {U"\u0915\u093F"sv, {2}},
+	    {U"\u0600a b"sv, {2, 1, 1}},
+	    {U"\u0600\n"sv, {1, 1}},
+	    // GB11: emoji ZWJ sequences
+	    {U"\U0001F469\u200D\U0001F469\u200D\U0001F467"sv, {5}},
+	    {U"\U0001F44D\U0001F3FD\u200D\U0001F525"sv, {4}},
+	    {U"a\u200D\U0001F525"sv, {2, 1}},
+	    {U"\U0001F469\u200D\u200D\U0001F469"sv, {3, 1}},
+	    {U"\U0001F469\u0301\u200D\U0001F469"sv, {4}},
+	    // GB12, GB13: regional indicators pair up
+	    {U"\U0001F1F5\U0001F1F1\U0001F1E9\U0001F1EA\U0001F1EB"sv, {2, 2, 1}},
+	    {U"a\U0001F1F5\U0001F1F1\u0301"sv, {1, 3}},
+	    // a lone combining mark, and one after a space
+	    {U"\u0301a"sv, {1, 1}},
+	    {U" \u0301"sv, {2}},
+	};
+
+	template <typename Char>
+	static std::size_t count_code_points(std::basic_string_view<Char> text) {
+		if constexpr (sizeof(Char) == 4)
+			return text.size();
+		else
+			return as_u32(text).size();
+	}
+
+	template <typename String>
+	static std::vector<std::size_t> split(String const& text) {
+		std::vector<std::size_t> lengths;
+		for (auto const cluster : graphemes(text))
+			lengths.push_back(count_code_points(cluster));
+		return lengths;
+	}
+
+	TEST(graphemes, rules) {
+		for (auto const& [text, lengths] : cases) {
+			auto const utf8 = as_str8(text);
+			auto const utf16 = as_u16(text);
+			EXPECT_EQ(lengths, split(utf8)) << utf8;
+			EXPECT_EQ(lengths, split(utf16)) << utf8;
+			EXPECT_EQ(lengths, split(std::u32string{text})) << utf8;
+			EXPECT_EQ(lengths.size(), count_graphemes(utf8)) << utf8;
+			EXPECT_EQ(lengths.size(), count_graphemes(utf16)) << utf8;
+			EXPECT_EQ(lengths.size(), count_graphemes(text)) << utf8;
+#ifdef __cpp_lib_char8_t
+			EXPECT_EQ(lengths.size(), count_graphemes(as_u8_view(utf8)))
+			    << utf8;
+#endif
+		}
+	}
+
+	TEST(graphemes, clusters) {
+		auto const text = "ne\u0301\u00E9\U0001F1F5\U0001F1F1!"sv;
+		std::vector<std::string_view> clusters;
+		for (auto const cluster : graphemes(text))
+			clusters.push_back(cluster);
+		EXPECT_EQ((std::vector{"n"sv, "e\u0301"sv, "\u00E9"sv,
+		                       "\U0001F1F5\U0001F1F1"sv, "!"sv}),
+		          clusters);
+		EXPECT_EQ(1u, grapheme_length(text));
+		EXPECT_EQ(3u, grapheme_length(text.substr(1)));
+		EXPECT_EQ(0u, grapheme_length(""sv));
+	}
+
+	TEST(graphemes, ascii_runs) {
+		// the last character of a run may take the marks after it
+		for (std::size_t size = 1; size < 40; ++size) {
+			auto text = std::string(size, 'a');
+			EXPECT_EQ(size, count_graphemes(text));
+			text += "\u0301";
+			EXPECT_EQ(size, count_graphemes(text)) << size;
+			text.insert(size / 2, "\r\n");
+			EXPECT_EQ(size + 1, count_graphemes(text)) << size;
+			text.insert(size / 2, "\r");
+			EXPECT_EQ(size + 2, count_graphemes(text)) << size;
+			auto const utf16 = as_u16(text);
+			EXPECT_EQ(size + 2, count_graphemes(utf16)) << size;
+			EXPECT_EQ(size + 2, split(utf16).size()) << size;
+		}
+	}
+
+	TEST(graphemes, ill_formed) {
+		// every ill-formed sequence stands alone, marks after it included
+		auto const text = "a\xC4\xFF\xE2\x82\u0301"sv;
+		std::vector<std::string_view> clusters;
+		for (auto const cluster : graphemes(text))
+			clusters.push_back(cluster);
+		EXPECT_EQ((std::vector{"a"sv, "\xC4"sv, "\xFF"sv, "\xE2\x82"sv,
+		                       "\u0301"sv}),
+		          clusters);
+
+		auto const utf16 = u"a\xDC00\u0301\xD800"sv;
+		EXPECT_EQ(4u, count_graphemes(utf16));
+		auto const utf32 = U"a\x110000\u0301"sv;
+		EXPECT_EQ(3u, count_graphemes(utf32));
+	}
+}  // namespace utf::testing
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <utf/utf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	template <typename Char>
+	std::string_view utf8_of(std::basic_string<Char> const& buffer,
+	                         transcode_result const& result) {
+		return {reinterpret_cast<char const*>(buffer.data()), result.written};
+	}
+
+	std::vector<std::byte> bytes_of(std::string_view bytes) {
+		std::vector<std::byte> result(bytes.size());
+		std::memcpy(result.data(), bytes.data(), bytes.size());
+		return result;
+	}
+
+	std::string_view utf8_of(std::vector<std::byte> const& buffer) {
+		return {reinterpret_cast<char const*>(buffer.data()), buffer.size()};
+	}
+
+	TEST(in_place, utf32) {
+		auto const text = U"zażółć gęślą jaźń \U0001F600 \xD800 \x110000"sv;
+		std::u32string buffer{text};
+		auto const result = as_str8_in_place(buffer);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(text.size(), result.read);
+		EXPECT_EQ(as_str8(text), utf8_of(buffer, result));
+	}
+
+	TEST(in_place, utf16) {
+		auto text = std::u16string(100, u'a') + u"ąę \U0001F600" +
+		            std::u16string(50, u'b');
+		auto buffer = text;
+		auto const result = as_str8_in_place(buffer);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(text.size(), result.read);
+		EXPECT_EQ(as_str8(text), utf8_of(buffer, result));
+	}
+
+	TEST(in_place, utf16_expands) {
+		// three bytes for a single unit, with only one byte saved before it
+		auto const text = u"a\u20AC\u20ACb"sv;
+		std::u16string buffer{text};
+		auto const result = as_str8_in_place(buffer);
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_EQ(2u, result.read);
+		EXPECT_EQ("a\xE2\x82\xAC"sv, utf8_of(buffer, result));
+		EXPECT_EQ(text.substr(result.read),
+		          std::u16string_view{buffer}.substr(result.read));
+
+		// each ASCII character makes room for one more byte
+		buffer = u"ab\u20AC\u20AC"s;
+		auto const fits = as_str8_in_place(buffer);
+		EXPECT_EQ(transcode_status::ok, fits.status);
+		EXPECT_EQ("ab\xE2\x82\xAC\xE2\x82\xAC"sv, utf8_of(buffer, fits));
+	}
+
+	TEST(in_place, utf16_errors) {
+		std::u16string buffer{u"ab\xDC00"};
+		EXPECT_EQ(transcode_status::invalid, as_str8_in_place(buffer).status);
+
+		buffer = u"ab\xD800";
+		auto const result = as_str8_in_place(buffer);
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+		EXPECT_EQ(2u, result.read);
+	}
+
+	TEST(in_place, bytes) {
+		auto buffer = bytes_of("a\0\x05\x01\x3D\xD8\x00\xDE"sv);
+		auto result = as_str8_in_place(buffer, encoding::utf16le);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ("a\xC4\x85\xF0\x9F\x98\x80"sv, utf8_of(buffer));
+
+		buffer = bytes_of("\0\0\0a\0\0\x01\x05"sv);
+		result = as_str8_in_place(buffer, encoding::utf32be);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ("a\xC4\x85"sv, utf8_of(buffer));
+
+		buffer = bytes_of("\0a\0b\0"sv);
+		result = as_str8_in_place(buffer, encoding::utf16be);
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+		EXPECT_EQ(5u, buffer.size());
+
+		buffer = bytes_of("ab\xC4\x85"sv);
+		result = as_str8_in_place(buffer, encoding::utf8);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(4u, buffer.size());
+
+		buffer = bytes_of("ab\xC4"sv);
+		result = as_str8_in_place(buffer, encoding::utf8);
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+		EXPECT_EQ(2u, result.read);
+	}
+}  // namespace utf::testing
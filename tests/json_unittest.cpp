@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <utf/json.hpp>
+#include <utf/utf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(json, escape_utf16) {
+		EXPECT_EQ(R"(say \"zażółć\"\n)"s,
+		          json_escape(u"say \"zażółć\"\n"sv));
+		EXPECT_EQ(R"(\\ / \u0001 \t 😀)"s,
+		          json_escape(u"\\ / \x01 \t \U0001F600"sv));
+	}
+
+	TEST(json, escape_long) {
+		std::u16string text(100, u'a');
+		text += u"\"ą\x1f";
+		text.append(50, u'b');
+		auto const expected =
+		    std::string(100, 'a') + R"(\"ą\u001f)" + std::string(50, 'b');
+		EXPECT_EQ(expected, json_escape(text));
+		EXPECT_EQ(expected, json_escape(as_u32(text)));
+		EXPECT_EQ(expected, json_escape(as_str8(text)));
+	}
+
+	TEST(json, escape_ill_formed) {
+		EXPECT_TRUE(json_escape(u"ab\xD800"sv).empty());
+		EXPECT_TRUE(json_escape("ab\xE2\x82"sv).empty());
+		EXPECT_TRUE(json_escape(U"\xD800"sv).empty());
+		EXPECT_TRUE(json_escape(U"ab\x110000"sv).empty());
+	}
+
+	TEST(json, unescape) {
+		auto const escaped = R"(a\"b\\c\/d\b\f\n\r\t ą 😀 ż)"sv;
+		auto const expected = u"a\"b\\c/d\b\f\n\r\t ą \U0001F600 ż"sv;
+		EXPECT_EQ(expected, json_unescape_u16(escaped));
+		EXPECT_EQ(as_str8(expected), json_unescape(escaped));
+	}
+
+	TEST(json, unescape_long) {
+		auto const escaped =
+		    std::string(40, 'x') + R"(\u00e9)" + std::string(40, 'y');
+		auto const expected =
+		    std::string(40, 'x') + "é" + std::string(40, 'y');
+		EXPECT_EQ(expected, json_unescape(escaped));
+		EXPECT_EQ(as_u16(expected), json_unescape_u16(escaped));
+	}
+
+	TEST(json, unescape_errors) {
+		EXPECT_TRUE(json_unescape(R"(\uD83D)"sv).empty());
+		EXPECT_TRUE(json_unescape(R"(\uD83Dx)"sv).empty());
+		EXPECT_TRUE(json_unescape(R"(\uD83DA)"sv).empty());
+		EXPECT_TRUE(json_unescape(R"(\uDE00)"sv).empty());
+		EXPECT_TRUE(json_unescape(R"(\u12)"sv).empty());
+		EXPECT_TRUE(json_unescape(R"(\x)"sv).empty());
+		EXPECT_TRUE(json_unescape("a\"b"sv).empty());
+		EXPECT_TRUE(json_unescape("a\nb"sv).empty());
+		EXPECT_TRUE(json_unescape("a\xE2\x82"sv).empty());
+		EXPECT_TRUE(json_unescape_u16("a\\"sv).empty());
+	}
+
+	TEST(json, round_trip) {
+		auto const text = u"ŧĥê \"qũïçķ\"\tƋȓôŵñ\n\U0001F98A"sv;
+		EXPECT_EQ(text, json_unescape_u16(json_escape(text)));
+	}
+}  // namespace utf::testing
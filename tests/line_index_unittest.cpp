@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <utf/line_index.hpp>
+#include <utf/utf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	struct expected_position {
+		std::size_t offset;
+		line_column code_points;
+		line_column utf16;
+	};
+
+	// the position of every code point, counted one by one
+	template <typename Char>
+	static std::vector<expected_position> reference_positions(
+	    std::u32string_view text) {
+		std::vector<expected_position> result;
+		std::size_t offset{}, line{}, column{}, column16{};
+		for (auto const code_point : text) {
+			result.push_back({offset, {line, column}, {line, column16}});
+			if constexpr (sizeof(Char) == 1)
+				offset += as_str8(std::u32string_view{&code_point, 1}).size();
+			else
+				offset += code_point > 0xFFFF ? 2 : 1;
+			++column;
+			column16 += code_point > 0xFFFF ? 2 : 1;
+			if (code_point == U'\n') {
+				++line;
+				column = column16 = 0;
+			}
+		}
+		result.push_back({offset, {line, column}, {line, column16}});
+		return result;
+	}
+
+	template <typename Char>
+	static void expect_positions(basic_line_index<Char> const& index,
+	                             std::u32string_view text) {
+		for (auto const& expected : reference_positions<Char>(text)) {
+			auto const pos = index.position(expected.offset);
+			EXPECT_EQ(expected.code_points.line, pos.line) << expected.offset;
+			EXPECT_EQ(expected.code_points.column, pos.column)
+			    << expected.offset;
+			auto const pos16 =
+			    index.position(expected.offset, column_unit::utf16);
+			EXPECT_EQ(expected.utf16.column, pos16.column) << expected.offset;
+
+			EXPECT_EQ(expected.offset, index.offset(expected.code_points))
+			    << expected.offset;
+			EXPECT_EQ(expected.offset,
+			          index.offset(expected.utf16, column_unit::utf16))
+			    << expected.offset;
+		}
+	}
+
+	static std::u32string sample_text(std::size_t lines) {
+		static constexpr std::u32string_view words[] = {
+		    U"lorem ", U"zażółć ", U"съешь ", U"漢字 ", U"😀🚀 ", U"\n",
+		};
+		std::mt19937 random{5489u};
+		std::u32string text;
+		for (std::size_t line = 0; line < lines;) {
+			auto const& word = words[random() % std::size(words)];
+			if (word == U"\n") ++line;
+			text += word;
+		}
+		return text;
+	}
+
+	TEST(line_index, empty) {
+		line_index index{""sv};
+		EXPECT_EQ(1u, index.lines());
+		EXPECT_EQ(0u, index.position(0).line);
+		EXPECT_EQ(0u, index.position(10).column);
+		EXPECT_EQ(0u, index.offset({0, 5}));
+		EXPECT_EQ(0u, index.offset({3, 0}));
+	}
+
+	TEST(line_index, short_text) {
+		auto const text = "zażółć\n\U0001F600 gęślą\n"sv;
+		line_index index{text};
+		EXPECT_EQ(3u, index.lines());
+		EXPECT_EQ(11u, index.line_start(1));
+		EXPECT_EQ(text.size(), index.line_start(2));
+		EXPECT_EQ(text.size(), index.line_start(3));
+
+		EXPECT_EQ(1u, index.position(16).line);
+		EXPECT_EQ(2u, index.position(16).column);
+		EXPECT_EQ(3u, index.position(16, column_unit::utf16).column);
+		// the middle of a code point belongs to its start
+		EXPECT_EQ(3u, index.position(4).column);
+		EXPECT_EQ(3u, index.position(5).column);
+
+		// columns past the end of the line stop at its newline
+		EXPECT_EQ(10u, index.offset({0, 100}));
+		EXPECT_EQ(text.size(), index.offset({2, 100}));
+		// a column inside a surrogate pair gives the start of the pair
+		EXPECT_EQ(11u, index.offset({1, 1}, column_unit::utf16));
+	}
+
+	TEST(line_index, utf8) {
+		auto const text = sample_text(300);
+		auto const utf8 = as_str8(text);
+		line_index index{utf8};
+		EXPECT_EQ(301u, index.lines());
+		expect_positions(index, text);
+	}
+
+	TEST(line_index, utf16) {
+		auto const text = sample_text(300);
+		auto const utf16 = as_u16(text);
+		u16line_index index{utf16};
+		EXPECT_EQ(301u, index.lines());
+		expect_positions(index, text);
+	}
+
+	TEST(line_index, long_lines) {
+		// checkpoints in the middle of lines, of code points and of pairs
+		for (std::size_t prefix = 0; prefix < 4; ++prefix) {
+			auto text = std::u32string(prefix, U'a');
+			for (int repeat = 0; repeat < 400; ++repeat)
+				text += U"ż漢😀"sv;
+			text += U"\nend"sv;
+
+			auto const utf8 = as_str8(text);
+			expect_positions(line_index{utf8}, text);
+			auto const utf16 = as_u16(text);
+			expect_positions(u16line_index{utf16}, text);
+		}
+	}
+
+	template <typename Char>
+	static void check_edits() {
+		auto text = sample_text(120);
+		auto buffer = std::basic_string<Char>{};
+		auto const encode = [](std::u32string_view src) {
+			if constexpr (sizeof(Char) == 1)
+				return as_str8(src);
+			else
+				return as_u16(src);
+		};
+		buffer = encode(text);
+		basic_line_index<Char> index{buffer};
+
+		std::mt19937 random{1234u};
+		static constexpr std::u32string_view inserts[] = {
+		    U"", U"x", U"\n", U"ż\n😀", U"漢字\n\n",
+		};
+		for (int edit = 0; edit < 200; ++edit) {
+			auto const from = random() % (text.size() + 1);
+			auto const count =
+			    std::min<std::size_t>(random() % 40, text.size() - from);
+			auto insert =
+			    std::u32string{inserts[random() % std::size(inserts)]};
+			if (edit % 10 == 0) insert = sample_text(5);
+
+			auto const offset = encode(text.substr(0, from)).size();
+			auto const removed = encode(text.substr(from, count)).size();
+			text.replace(from, count, insert);
+			buffer = encode(text);
+			index.update(buffer, offset, removed, encode(insert).size());
+
+			basic_line_index<Char> fresh{buffer};
+			ASSERT_EQ(fresh.lines(), index.lines()) << edit;
+			for (std::size_t line = 0; line < fresh.lines(); ++line)
+				ASSERT_EQ(fresh.line_start(line), index.line_start(line))
+				    << edit << ' ' << line;
+			if (edit % 20 == 0) expect_positions(index, text);
+		}
+		expect_positions(index, text);
+	}
+
+	TEST(line_index, utf8_edits) { check_edits<char>(); }
+	TEST(line_index, utf16_edits) { check_edits<char16_t>(); }
+}  // namespace utf::testing
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <utf/normalize.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(normalize, unchanged) {
+		auto const text = "za\u017C\u00F3\u0142\u0107 g\u0119\u015Bl\u0105"sv;
+		std::string buffer;
+		EXPECT_TRUE(is_nfc_quick(text));
+		auto const nfc = to_nfc(text, buffer);
+		EXPECT_EQ(text.data(), nfc.data());
+		EXPECT_EQ(text.size(), nfc.size());
+		EXPECT_TRUE(buffer.empty());
+
+		auto const ascii = u"plain ASCII"sv;
+		std::u16string buffer16;
+		EXPECT_EQ(ascii.data(), to_nfd(ascii, buffer16).data());
+		EXPECT_EQ(ascii.data(), to_nfc(ascii, buffer16).data());
+		EXPECT_TRUE(buffer16.empty());
+	}
+
+	TEST(normalize, compose) {
+		EXPECT_FALSE(is_nfc_quick("e\u0301"sv));
+		EXPECT_EQ("\u00E9"s, to_nfc("e\u0301"sv));
+		EXPECT_EQ(u"caf\u00E9!"s, to_nfc(u"cafe\u0301!"sv));
+		EXPECT_EQ(U"\u1EC7"s, to_nfc(U"e\u0323\u0302"sv));
+		// the marks are reordered by their combining classes first
+		EXPECT_EQ(U"\u1EC7"s, to_nfc(U"e\u0302\u0323"sv));
+		// blocked by a mark of the same class
+		EXPECT_EQ(U"\u00E1\u0301"s, to_nfc(U"a\u0301\u0301"sv));
+
+		std::string buffer;
+		auto const text = "abc e\u0301"sv;
+		auto const nfc = to_nfc(text, buffer);
+		EXPECT_EQ(buffer.data(), nfc.data());
+		EXPECT_EQ("abc \u00E9"sv, nfc);
+	}
+
+	TEST(normalize, decompose) {
+		EXPECT_EQ("e\u0301"s, to_nfd("\u00E9"sv));
+		EXPECT_EQ(u"e\u0323\u0302"s, to_nfd(u"\u1EC7"sv));
+		EXPECT_EQ(U"e\u0323\u0302"s, to_nfd(U"e\u0302\u0323"sv));
+		EXPECT_EQ(U"A\u030A"s, to_nfd(U"\u212B"sv));
+	}
+
+	TEST(normalize, singletons_and_exclusions) {
+		EXPECT_FALSE(is_nfc_quick(u"\u212B"sv));
+		EXPECT_EQ(u"\u00C5"s, to_nfc(u"\u212B"sv));
+		EXPECT_EQ(u"\u0915\u093C"s, to_nfc(u"\u0958"sv));
+		EXPECT_EQ(U"\U0001D157\U0001D165"s, to_nfc(U"\U0001D15E"sv));
+	}
+
+	TEST(normalize, hangul) {
+		EXPECT_TRUE(is_nfc_quick(u"\uD55C\uAE00"sv));
+		EXPECT_EQ(u"\u1112\u1161\u11AB"s, to_nfd(u"\uD55C"sv));
+		EXPECT_EQ(u"\uD55C"s, to_nfc(u"\u1112\u1161\u11AB"sv));
+		EXPECT_EQ(u"\uD55C"s, to_nfc(u"\uD558\u11AB"sv));
+	}
+
+	TEST(normalize, ill_formed) {
+		std::string buffer{"old"};
+		EXPECT_FALSE(is_nfc_quick("abc\xC3"sv));
+		EXPECT_TRUE(to_nfc("abc\xC3"sv, buffer).empty());
+		EXPECT_TRUE(buffer.empty());
+		EXPECT_TRUE(to_nfd("\u00E9\xFF"sv).empty());
+		EXPECT_TRUE(to_nfc(u"\xD800"sv).empty());
+		EXPECT_TRUE(to_nfc(U"\x110000"sv).empty());
+		EXPECT_FALSE(is_nfc_quick("\xC0\x80"sv));
+	}
+
+	TEST(normalize, blocks) {
+		// a combining mark at every place relative to the block boundaries
+		for (std::size_t pos = 0; pos < 70; ++pos) {
+			auto const expected = std::u16string(70, u'\u00F3');
+			auto text = expected;
+			text[pos] = u'o';
+			text.insert(pos + 1, u"\u0301");
+			EXPECT_FALSE(is_nfc_quick(text)) << pos;
+			EXPECT_EQ(expected, to_nfc(text)) << pos;
+
+			std::string utf8;
+			std::string expected8;
+			for (std::size_t index = 0; index < 70; ++index) {
+				utf8 += index == pos ? "o\u0301" : "\u00F3";
+				expected8 += "\u00F3";
+			}
+			EXPECT_FALSE(is_nfc_quick(utf8)) << pos;
+			EXPECT_EQ(expected8, to_nfc(utf8)) << pos;
+			EXPECT_TRUE(is_nfc_quick(expected8)) << pos;
+
+			auto utf32 = std::u32string(70, U'a');
+			utf32[pos] = U'\u0300';
+			EXPECT_FALSE(is_nfc_quick(utf32)) << pos;
+			EXPECT_EQ(pos ? 69u : 70u, to_nfc(utf32).size()) << pos;
+		}
+	}
+
+#ifdef __cpp_lib_char8_t
+	TEST(normalize, utf8) {
+		EXPECT_TRUE(is_nfc_quick(u8"\u00E9"sv));
+		EXPECT_EQ(u8"\u00E9"s, to_nfc(u8"e\u0301"sv));
+		EXPECT_EQ(u8"e\u0301"s, to_nfd(u8"\u00E9"sv));
+	}
+#endif
+}  // namespace utf::testing
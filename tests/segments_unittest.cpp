@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <utf/segments.hpp>
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#endif
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	// a pool of fixed-size buffers, handed out until there are no more
+	struct pool {
+		std::vector<std::vector<char>> buffers;
+		std::size_t given{};
+
+		pool(std::size_t count, std::size_t size)
+		    : buffers(count, std::vector<char>(size)) {}
+
+		segment_source source() {
+			return [this]() -> segment {
+				if (given == buffers.size()) return {};
+				auto& buffer = buffers[given++];
+				return {buffer.data(), buffer.size()};
+			};
+		}
+	};
+
+	std::string joined(segments_result const& result) {
+		std::string out;
+		for (auto const& piece : result.segments)
+			out.append(static_cast<char const*>(piece.base), piece.length);
+		return out;
+	}
+
+#if __has_include(<sys/uio.h>)
+	static_assert(sizeof(segment) == sizeof(iovec));
+	static_assert(offsetof(segment, base) == offsetof(iovec, iov_base));
+	static_assert(offsetof(segment, length) == offsetof(iovec, iov_len));
+#endif
+
+	TEST(segments, whole_code_points) {
+		auto const text = u"zażółć gęślą jaźń \U0001F600"sv;
+		pool buffers{16, 4};
+		auto const result = transcode_segments(text, buffers.source());
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(text.size(), result.read);
+		EXPECT_EQ(as_str8(text), joined(result));
+		EXPECT_EQ(as_str8(text).size(), result.written);
+		for (auto const& piece : result.segments) {
+			EXPECT_LE(piece.length, 4u);
+			// every piece is valid UTF-8 on its own
+			EXPECT_TRUE(is_valid(std::string_view{
+			    static_cast<char const*>(piece.base), piece.length}));
+		}
+	}
+
+	TEST(segments, split_code_points) {
+		auto const text = U"ąąąąą"sv;
+		pool buffers{4, 3};
+		auto const result = transcode_segments(
+		    text, buffers.source(), on_error::stop, code_point_split::allowed);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(as_str8(text), joined(result));
+		ASSERT_EQ(4u, result.segments.size());
+		for (std::size_t index = 0; index < 3; ++index)
+			EXPECT_EQ(3u, result.segments[index].length) << index;
+		EXPECT_EQ(1u, result.segments[3].length);
+	}
+
+	TEST(segments, out_of_buffers) {
+		auto const text = "abcdef\xC4\x85xyz"sv;
+		pool buffers{2, 4};
+		auto result = transcode_segments(text, buffers.source());
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_EQ(8u, result.read);
+		EXPECT_EQ(text.substr(0, result.read), joined(result));
+
+		// the split code point is not kept, if the buffers run out in it
+		pool tiny{2, 2};
+		result = transcode_segments("ab\xF0\x9F\x98\x80"sv, tiny.source(),
+		                            on_error::stop, code_point_split::allowed);
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_EQ(2u, result.read);
+		EXPECT_EQ("ab"sv, joined(result));
+
+		pool none{0, 0};
+		result = transcode_segments("a"sv, none.source());
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_TRUE(result.segments.empty());
+	}
+
+	TEST(segments, errors) {
+		pool buffers{4, 8};
+		auto result = transcode_segments(u"ab\xDC00"sv, buffers.source());
+		EXPECT_EQ(transcode_status::invalid, result.status);
+		EXPECT_EQ(2u, result.read);
+		EXPECT_EQ("ab"sv, joined(result));
+
+		pool more{4, 8};
+		result = transcode_segments(u"ab\xDC00"sv, more.source(),
+		                            on_error::replace);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ("ab\xEF\xBF\xBD"sv, joined(result));
+
+		pool last{4, 8};
+		result = transcode_segments(u"ab\xD800"sv, last.source());
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+		EXPECT_EQ(2u, result.read);
+	}
+
+	TEST(segments, tiny_buffers_are_skipped) {
+		// a buffer too short for the next code point is left unused
+		std::vector<std::size_t> sizes{1, 2, 1, 4, 8};
+		std::vector<std::vector<char>> buffers;
+		for (auto size : sizes)
+			buffers.emplace_back(size);
+		std::size_t given = 0;
+		auto const result = transcode_segments(
+		    U"a\U0001F600b"sv, [&]() -> segment {
+			    if (given == buffers.size()) return {};
+			    auto& buffer = buffers[given++];
+			    return {buffer.data(), buffer.size()};
+		    });
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ("a\xF0\x9F\x98\x80" "b"sv, joined(result));
+		ASSERT_EQ(3u, result.segments.size());
+		EXPECT_EQ(buffers[0].data(), result.segments[0].base);
+		EXPECT_EQ(buffers[3].data(), result.segments[1].base);
+		EXPECT_EQ(buffers[4].data(), result.segments[2].base);
+	}
+}  // namespace utf::testing
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <utf/streambuf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	std::string utf16le(std::u16string_view text) {
+		std::string bytes;
+		for (auto unit : text) {
+			bytes.push_back(static_cast<char>(unit & 0xFF));
+			bytes.push_back(static_cast<char>(unit >> 8));
+		}
+		return bytes;
+	}
+
+	std::string utf32be(std::u32string_view text) {
+		std::string bytes;
+		for (auto unit : text) {
+			for (int shift = 24; shift >= 0; shift -= 8)
+				bytes.push_back(static_cast<char>((unit >> shift) & 0xFF));
+		}
+		return bytes;
+	}
+
+	std::string read_all(std::string const& bytes,
+	                     encoding external,
+	                     on_error errors = on_error::replace,
+	                     std::size_t block_size = 16) {
+		std::stringbuf underlying{bytes};
+		transcoding_streambuf buf{&underlying, external, errors, block_size};
+		std::istream in{&buf};
+		std::string text;
+		char block[7];
+		while (in.read(block, sizeof(block)) || in.gcount())
+			text.append(block, static_cast<std::size_t>(in.gcount()));
+		return text;
+	}
+
+	std::string write_all(std::string_view text,
+	                      encoding external,
+	                      on_error errors = on_error::replace,
+	                      std::size_t block_size = 16) {
+		std::stringbuf underlying;
+		{
+			transcoding_streambuf buf{&underlying, external, errors,
+			                          block_size};
+			std::ostream out{&buf};
+			out << text;
+		}
+		return underlying.str();
+	}
+
+	auto const sample =
+	    u"ŧĥê qũïçķ Ƌȓôŵñ ƒôx ĵũmpş ôvêȓ ȧ ĺȧȥÿ đôğ \U0001F600\U0001F600"sv;
+
+	TEST(streambuf, read_utf16le) {
+		EXPECT_EQ(as_str8(sample),
+		          read_all(utf16le(sample), encoding::utf16le));
+	}
+
+	TEST(streambuf, read_utf32be) {
+		auto const text = as_u32(sample);
+		EXPECT_EQ(as_str8(sample), read_all(utf32be(text), encoding::utf32be));
+	}
+
+	TEST(streambuf, read_truncated) {
+		auto bytes = utf16le(u"ab\U0001F600"sv);
+		bytes.pop_back();
+		EXPECT_EQ("ab\xEF\xBF\xBD"s, read_all(bytes, encoding::utf16le));
+		EXPECT_EQ("ab"s, read_all(bytes, encoding::utf16le, on_error::stop));
+	}
+
+	TEST(streambuf, write_utf16le) {
+		EXPECT_EQ(utf16le(sample),
+		          write_all(as_str8(sample), encoding::utf16le));
+	}
+
+	TEST(streambuf, write_utf32be) {
+		EXPECT_EQ(utf32be(as_u32(sample)),
+		          write_all(as_str8(sample), encoding::utf32be));
+	}
+
+	TEST(streambuf, write_truncated) {
+		EXPECT_EQ(utf16le(u"ab\xFFFD"sv),
+		          write_all("ab\xF0\x9F\x98"sv, encoding::utf16le));
+	}
+
+	TEST(streambuf, round_trip_large) {
+		std::string text;
+		for (int i = 0; i < 1000; ++i)
+			text += as_str8(sample);
+		auto const utf16 = write_all(text, encoding::utf16le, on_error::stop,
+		                             transcoding_streambuf::default_block_size);
+		EXPECT_EQ(utf16le(as_u16(text)), utf16);
+		EXPECT_EQ(text,
+		          read_all(utf16, encoding::utf16le, on_error::stop, 100));
+	}
+}  // namespace utf::testing
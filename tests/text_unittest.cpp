@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <utf/text.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(text, conversions) {
+		auto const utf8 = "zażółć \U0001F600"sv;
+		auto const utf16 = u"zażółć \U0001F600"sv;
+		auto const utf32 = U"zażółć \U0001F600"sv;
+
+		for (auto const& value : {text{utf8}, text{utf16}, text{utf32}}) {
+			EXPECT_EQ(utf8, value.str8());
+			EXPECT_EQ(utf16, value.u16());
+			EXPECT_EQ(utf32, value.u32());
+			EXPECT_EQ(8u, value.code_points());
+			EXPECT_FALSE(value.is_ascii());
+			EXPECT_FALSE(value.empty());
+		}
+	}
+
+	TEST(text, ascii) {
+		auto const long_text = std::string(100, 'x') + "-y";
+		text const value{long_text};
+		EXPECT_TRUE(value.is_ascii());
+		EXPECT_EQ(102u, value.code_points());
+		EXPECT_EQ(as_u16(long_text), value.u16());
+		EXPECT_EQ(as_u32(long_text), value.u32());
+
+		text const wide{as_u16(long_text)};
+		EXPECT_TRUE(wide.is_ascii());
+		EXPECT_EQ(long_text, wide.str8());
+		EXPECT_EQ(as_u32(long_text), wide.u32());
+	}
+
+	TEST(text, cached) {
+		text const value{u"gęślą"sv};
+		auto const first = value.str8();
+		auto const copy = value;
+		EXPECT_EQ(first.data(), copy.str8().data());
+		EXPECT_EQ(value.u16().data(), copy.u16().data());
+	}
+
+	TEST(text, ill_formed) {
+		text const value{"ab\xC4"sv};
+		EXPECT_TRUE(value.empty());
+		EXPECT_TRUE(value.u16().empty());
+		EXPECT_EQ(0u, value.code_points());
+		EXPECT_TRUE(text{}.empty());
+	}
+
+	TEST(text, threads) {
+		text const value{U"jaźń \U0001F600 jaźń"sv};
+		std::vector<std::thread> threads;
+		std::vector<char16_t const*> seen(8);
+		for (std::size_t index = 0; index < seen.size(); ++index) {
+			threads.emplace_back(
+			    [&, index] { seen[index] = value.u16().data(); });
+		}
+		for (auto& thread : threads)
+			thread.join();
+		for (auto const ptr : seen)
+			EXPECT_EQ(seen.front(), ptr);
+		EXPECT_EQ(u"jaźń \U0001F600 jaźń"sv, value.u16());
+	}
+}  // namespace utf::testing
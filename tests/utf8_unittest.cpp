@@ -185,6 +185,14 @@ namespace utf::testing {
 
 	struct utf_errors : utf_conv {};
 
+	std::wstring expected_wide(std::u16string const& utf16,
+	                           std::u32string const& utf32) {
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+			return {utf16.begin(), utf16.end()};
+		else
+			return {utf32.begin(), utf32.end()};
+	}
+
 	TEST_P(utf_conv, utf8) {
 #ifdef __cpp_lib_char8_t
 		auto [s8, u8, u16, u32, ign] = GetParam();
@@ -236,6 +244,363 @@ namespace utf::testing {
 		EXPECT_TRUE(is_valid(u32));
 	}
 
+	TEST_P(utf_conv, wide) {
+#ifdef __cpp_lib_char8_t
+		auto [s8, u8, u16, u32, ign] = GetParam();
+#else
+		auto [s8, u16, u32, ign] = GetParam();
+#endif
+		auto const wide = expected_wide(u16, u32);
+		EXPECT_EQ(wide, as_wstring(s8));
+		EXPECT_EQ(wide, as_wstring(u16));
+		EXPECT_EQ(wide, as_wstring(u32));
+		EXPECT_EQ(s8, as_str8(wide));
+		EXPECT_EQ(u16, as_u16(wide));
+		EXPECT_EQ(u32, as_u32(wide));
+#ifdef __cpp_lib_char8_t
+		EXPECT_EQ(wide, as_wstring(u8));
+		EXPECT_EQ(make_printable(u8), make_printable(as_u8(wide)));
+#endif
+
+		EXPECT_TRUE(is_valid(wide));
+	}
+
+	TEST(utf, wide_errors) {
+		EXPECT_TRUE(as_wstring("ab\xe2\x8f"sv).empty());
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+			auto const lone = std::wstring{L'a', static_cast<wchar_t>(0xD800)};
+			EXPECT_FALSE(is_valid(lone));
+			EXPECT_TRUE(as_str8(lone).empty());
+		} else {
+			auto const too_big =
+			    std::wstring{L'a', static_cast<wchar_t>(0x110000)};
+			EXPECT_EQ("a\xef\xbf\xbd"s, as_str8(too_big));
+		}
+	}
+
+#ifdef __cpp_lib_char8_t
+	TEST(utf, views) {
+		auto const str = "zażółć gęślą jaźń"sv;
+		auto const u8 = as_u8_view(str);
+		EXPECT_EQ(static_cast<void const*>(str.data()),
+		          static_cast<void const*>(u8.data()));
+		EXPECT_EQ(str.size(), u8.size());
+		EXPECT_EQ(str, as_str8_view(u8));
+
+		EXPECT_EQ(str.size(), as_u8_view(str, validate).size());
+		EXPECT_EQ(u8.size(), as_str8_view(u8, validate).size());
+
+		auto const bad = "ab\xe2\x8f"sv;
+		EXPECT_EQ(bad.size(), as_u8_view(bad).size());
+		EXPECT_TRUE(as_u8_view(bad, validate).empty());
+		EXPECT_TRUE(as_str8_view(as_u8_view(bad), validate).empty());
+	}
+#endif
+
+	TEST(utf, transcode_blocks) {
+		auto const src = u"zażółć \U0001F600"sv;
+		char block[5];
+		auto result = transcode(src, block, sizeof(block));
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_EQ(3u, result.read);
+		EXPECT_EQ(4u, result.written);
+		EXPECT_EQ("za\xc5\xbc"sv, std::string_view(block, result.written));
+
+		std::string out;
+		for (auto rest = src; !rest.empty();) {
+			result = transcode(rest, block, sizeof(block));
+			out.append(block, result.written);
+			rest.remove_prefix(result.read);
+		}
+		EXPECT_EQ(as_str8(src), out);
+	}
+
+	TEST(utf, transcode_errors) {
+		char16_t block[16];
+		auto const truncated = "ab\xe2\x8f"sv;
+		auto result = transcode(truncated, block, std::size(block));
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+		EXPECT_EQ(2u, result.read);
+		EXPECT_EQ(2u, result.written);
+
+		auto const invalid = "ab\xe2\x8f-\xff-"sv;
+		result = transcode(invalid, block, std::size(block));
+		EXPECT_EQ(transcode_status::invalid, result.status);
+		EXPECT_EQ(2u, result.read);
+
+		result = transcode(invalid, block, std::size(block), on_error::replace);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(invalid.size(), result.read);
+		EXPECT_EQ(u"ab\xFFFD-\xFFFD-"sv,
+		          std::u16string_view(block, result.written));
+
+		char u8block[16];
+		auto const lone = u"a\xD800"sv;
+		result = transcode(lone, u8block, std::size(u8block));
+		EXPECT_EQ(transcode_status::incomplete, result.status);
+		EXPECT_EQ(1u, result.read);
+		auto const paired = u"a\xD800-"sv;
+		result = transcode(paired, u8block, std::size(u8block));
+		EXPECT_EQ(transcode_status::invalid, result.status);
+	}
+
+	TEST(utf, long_ascii_runs) {
+		std::string text(100, 'a');
+		EXPECT_TRUE(is_valid(text));
+		text += "\xc4\x85";
+		text.append(37, 'b');
+		EXPECT_TRUE(is_valid(text));
+		text += "\xc4";
+		text.append(20, 'c');
+		EXPECT_FALSE(is_valid(text));
+	}
+
+	TEST(utf, kernel_offsets) {
+		for (std::size_t pos = 0; pos < 40; ++pos) {
+			auto const text = std::string(pos, 'a') + "\xF0\x9F\x98\x80" +
+			                  std::string(40 - pos, 'b');
+			auto const utf16 = std::u16string(pos, u'a') + u"\U0001F600" +
+			                   std::u16string(40 - pos, u'b');
+			EXPECT_TRUE(is_valid(text)) << pos;
+			EXPECT_EQ(utf16, as_u16(text)) << pos;
+			EXPECT_EQ(text, as_str8(utf16)) << pos;
+			EXPECT_EQ(pos + 1, find(text, U'b').code_points) << pos;
+			EXPECT_EQ(pos + 1, find(utf16, U'b').code_points) << pos;
+		}
+	}
+
+	// Table 3-7, Well-Formed UTF-8 Byte Sequences
+	static bool well_formed(unsigned lead, unsigned second) {
+		auto const in = [second](unsigned low, unsigned high) {
+			return second >= low && second <= high;
+		};
+		if (lead >= 0xC2 && lead <= 0xDF) return in(0x80, 0xBF);
+		if (lead == 0xE0) return in(0xA0, 0xBF);
+		if (lead == 0xED) return in(0x80, 0x9F);
+		if (lead >= 0xE1 && lead <= 0xEF) return in(0x80, 0xBF);
+		if (lead == 0xF0) return in(0x90, 0xBF);
+		if (lead == 0xF4) return in(0x80, 0x8F);
+		if (lead >= 0xF1 && lead <= 0xF3) return in(0x80, 0xBF);
+		return false;
+	}
+
+	TEST(utf, well_formed_table) {
+		for (unsigned lead = 0x80; lead < 0x100; ++lead) {
+			for (unsigned second = 0; second < 0x100; ++second) {
+				std::string seq{static_cast<char>(lead),
+				                static_cast<char>(second)};
+				auto const length = lead < 0xE0 ? 2u : lead < 0xF0 ? 3u : 4u;
+				seq.resize(length, '\x80');
+				EXPECT_EQ(well_formed(lead, second), is_valid(seq))
+				    << std::hex << lead << ' ' << second;
+				seq += "tail";
+				EXPECT_EQ(well_formed(lead, second), !as_u32(seq).empty())
+				    << std::hex << lead << ' ' << second;
+			}
+		}
+	}
+
+	TEST(utf, all_code_points) {
+		std::u32string all;
+		for (char32_t ch = 0; ch <= 0x10FFFF; ++ch) {
+			if (ch >= 0xD800 && ch <= 0xDFFF) continue;
+			all.push_back(ch);
+		}
+		auto const utf8 = as_str8(all);
+		EXPECT_TRUE(is_valid(utf8));
+		EXPECT_EQ(all, as_u32(utf8));
+	}
+
+	TEST(utf, block_profile) {
+		block_profile profile{};
+		auto const ascii = std::string(64, 'a');
+		auto const text = ascii + ascii + "zażółć" + ascii.substr(7) +
+		                  "漢字" + ascii.substr(6) + "\xF0\x9F\x98\x80";
+		auto const utf16 = as_u16(text, profile);
+		EXPECT_EQ(as_str8(utf16), text);
+		EXPECT_EQ(2u, profile.ascii);
+		EXPECT_EQ(1u, profile.two_byte);
+		EXPECT_EQ(1u, profile.three_byte);
+		EXPECT_EQ(1u, profile.four_byte);
+
+		// the counters add up over calls
+		EXPECT_EQ(as_u32(utf16), as_u32(text, profile));
+		EXPECT_EQ(4u, profile.ascii);
+		EXPECT_EQ(2u, profile.four_byte);
+	}
+
+	TEST(utf, exact_output_size) {
+		std::string text;
+		for (int count = 0; count < 1000; ++count)
+			text += "漢字\xF0\x9F\x98\x80" "a";
+		auto const utf32 = as_u32(text);
+		EXPECT_EQ(4000u, utf32.size());
+		EXPECT_LT(utf32.capacity(), utf32.size() + 16);
+		auto const utf16 = as_u16(text);
+		EXPECT_EQ(5000u, utf16.size());
+		EXPECT_LT(utf16.capacity(), utf16.size() + 16);
+	}
+
+	TEST(utf, block_boundaries) {
+		auto const sequences = {"\xC4\x85"sv, "\xE6\xBC\xA2"sv,
+		                        "\xF0\x9F\x98\x80"sv};
+		auto const broken = {"\xC4"sv,         "\xC1\xBF"sv,
+		                     "\xE6\xBC"sv,     "\xE0\x9F\xBF"sv,
+		                     "\xED\xA0\x80"sv, "\xF4\x90\x80\x80"sv,
+		                     "\xF0\x8F\xBF\xBF"sv, "\xF8\x88\x80\x80"sv,
+		                     "\x80"sv};
+		for (std::size_t pos = 56; pos < 72; ++pos) {
+			for (auto const seq : sequences) {
+				// the same kind of sequence on both sides of the boundary
+				auto const text = std::string(pos, 'a') + std::string{seq} +
+				                  std::string{seq} + "b";
+				auto const utf32 = as_u32(text);
+				ASSERT_FALSE(utf32.empty()) << pos << ' ' << seq.size();
+				EXPECT_EQ(text, as_str8(utf32)) << pos << ' ' << seq.size();
+				EXPECT_EQ(text, as_str8(as_u16(text)))
+				    << pos << ' ' << seq.size();
+
+				for (auto const bad : broken) {
+					auto const before = std::string(pos, 'a') +
+					                    std::string{seq} + std::string{bad};
+					EXPECT_TRUE(as_u16(before).empty()) << pos;
+					EXPECT_TRUE(as_u32(before + "tail").empty()) << pos;
+				}
+			}
+		}
+	}
+
+	TEST(utf, utf32_validation) {
+		EXPECT_TRUE(is_valid(U""sv));
+		EXPECT_TRUE(is_valid(U"\U0010FFFF\uD7FF\uE000"sv));
+		for (char32_t const bad : {0xD800u, 0xDBFFu, 0xDC00u, 0xDFFFu,
+		                           0x110000u, 0x7FFFFFFFu, 0xFFFFFFFFu}) {
+			for (std::size_t pos = 0; pos < 20; ++pos) {
+				auto text = std::u32string(20, U'a');
+				text[pos] = bad;
+				auto const code = static_cast<unsigned>(bad);
+				EXPECT_FALSE(is_valid(text)) << std::hex << code << ' ' << pos;
+				auto expected = std::u32string(20, U'a');
+				expected[pos] = U'\uFFFD';
+				EXPECT_EQ(expected, sanitize(text))
+				    << std::hex << code << ' ' << pos;
+			}
+		}
+	}
+
+	TEST(utf, sanitize) {
+		auto const good = U"zażółć \U0001F600"s;
+		EXPECT_EQ(good, sanitize(good));
+
+		std::u32string text;
+		std::u32string expected;
+		for (char32_t ch = 0xD000; ch < 0xE800; ++ch) {
+			text.push_back(ch);
+			expected.push_back(ch >= 0xD800 && ch <= 0xDFFF ? U'\uFFFD' : ch);
+		}
+		EXPECT_EQ(expected, sanitize(text));
+	}
+
+	TEST(utf, streaming) {
+		auto const text = [] {
+			std::u32string result;
+			while (result.size() < 20000)
+				result += U"zażółć 漢字 \U0001F600 "sv;
+			return result;
+		}();
+		auto const utf16 = as_u16(text);
+		auto const wide = as_wstring(text);
+
+		auto const previous = streaming_threshold();
+		// lengths around the staging buffers of every unit size
+		for (auto const size : {0u, 1u, 1000u, 1023u, 1024u, 1025u, 4093u,
+		                        4097u, 12345u, 20000u}) {
+			auto const src32 = std::u32string_view{text}.substr(0, size);
+			auto const src16 = std::u16string_view{utf16}.substr(
+			    0, as_u16(src32).size());
+			auto const src_wide = std::wstring_view{wide}.substr(0, size);
+
+			set_streaming_threshold(npos);
+			auto const utf8 = as_str8(src32);
+			auto const from16 = as_str8(src16);
+			auto const to32 = as_u32(src16);
+			auto const to16 = as_u16(src32);
+			auto const from_wide = as_str8(src_wide);
+			set_streaming_threshold(0);
+			EXPECT_EQ(utf8, as_str8(src32)) << size;
+			EXPECT_EQ(from16, as_str8(src16)) << size;
+			EXPECT_EQ(to32, as_u32(src16)) << size;
+			EXPECT_EQ(to16, as_u16(src32)) << size;
+			EXPECT_EQ(from_wide, as_str8(src_wide)) << size;
+			EXPECT_EQ(src_wide, as_wstring(utf8)) << size;
+		}
+
+		auto broken = utf16;
+		broken[broken.size() - 3] = u'\xDC00';
+		EXPECT_TRUE(as_str8(broken).empty());
+		EXPECT_TRUE(as_u32(broken).empty());
+
+#ifdef __cpp_lib_string_resize_and_overwrite
+		auto const strings = streamed_conversions();
+		auto const streamed_utf8 = as_str8(text);
+		EXPECT_EQ(strings + 1, streamed_conversions());
+		set_streaming_threshold(npos);
+		EXPECT_EQ(as_str8(text), streamed_utf8);
+#endif
+		set_streaming_threshold(previous);
+		EXPECT_EQ(previous, streaming_threshold());
+	}
+
+	TEST(utf, streaming_transcode) {
+		std::u16string text;
+		while (text.size() < 20000)
+			text += u"zażółć 漢字 \U0001F600 "sv;
+		auto const expected = as_str8(text);
+		std::string out(expected.size() + 16, '-');
+
+		auto const previous = streaming_threshold();
+		set_streaming_threshold(0);
+		auto const before = streamed_conversions();
+		auto result = transcode<char, char16_t>(text, out.data(), out.size());
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(text.size(), result.read);
+		EXPECT_EQ(expected, out.substr(0, result.written));
+		EXPECT_EQ(before + 1, streamed_conversions());
+
+		// a short buffer and ill-formed input are converted exactly
+		result = transcode<char, char16_t>(text, out.data(), 1000);
+		EXPECT_EQ(transcode_status::output_full, result.status);
+		EXPECT_EQ(expected.substr(0, result.written),
+		          out.substr(0, result.written));
+		EXPECT_GT(result.written, 996u);
+		EXPECT_LE(result.written, 1000u);
+
+		auto broken = text;
+		broken[broken.size() - 3] = u'\xDC00';
+		result = transcode<char, char16_t>(broken, out.data(), out.size());
+		EXPECT_EQ(transcode_status::invalid, result.status);
+		EXPECT_EQ(broken.size() - 3, result.read);
+		result = transcode<char, char16_t>(broken, out.data(), out.size(),
+		                                   on_error::replace);
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(broken.size(), result.read);
+		EXPECT_EQ(before + 1, streamed_conversions());
+
+		// UTF-32 values out of range are passed through, as before
+		std::u32string wide(5000, U'\xD800');
+		std::u32string copy(wide.size(), U'\0');
+		result = transcode<char32_t, char32_t>(wide, copy.data(), copy.size());
+		EXPECT_EQ(transcode_status::ok, result.status);
+		EXPECT_EQ(wide, copy);
+		EXPECT_EQ(before + 2, streamed_conversions());
+
+		set_streaming_threshold(npos);
+		result = transcode<char, char16_t>(text, out.data(), out.size());
+		EXPECT_EQ(expected, out.substr(0, result.written));
+		EXPECT_EQ(before + 2, streamed_conversions());
+		set_streaming_threshold(previous);
+	}
+
 	TEST_P(utf_errors, check) {
 #ifdef __cpp_lib_char8_t
 		auto [s8, u8, u16, u32, oper] = GetParam();
@@ -258,7 +623,9 @@ namespace utf::testing {
 				break;
 			case op::utf32to8:
 				ExpectUtfEq(u8, u32);
-				EXPECT_EQ(!u8.empty(), is_valid(u32)) << make_printable(u32);
+				// bad values are replaced, so only valid input round-trips
+				EXPECT_EQ(as_u32(u8) == u32, is_valid(u32))
+				    << make_printable(u32);
 				break;
 			case op::str8to8:
 				ExpectUtfEq(u8, s8);
@@ -287,11 +654,13 @@ namespace utf::testing {
 				break;
 			case op::utf32to8s:
 				ExpectUtfEq(s8, u32);
-				EXPECT_EQ(!s8.empty(), is_valid(u32)) << make_printable(u32);
+				EXPECT_EQ(as_u32(s8) == u32, is_valid(u32))
+				    << make_printable(u32);
 				break;
 			case op::utf32to16:
 				ExpectUtfEq(u16, u32);
-				EXPECT_EQ(!u16.empty(), is_valid(u32)) << make_printable(u32);
+				EXPECT_EQ(as_u32(u16) == u32, is_valid(u32))
+				    << make_printable(u32);
 				break;
 			default:
 				break;
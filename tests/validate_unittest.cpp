@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <utf/utf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(validate, offsets) {
+		EXPECT_EQ(npos, invalid_offset("zażółć"sv));
+		EXPECT_EQ(2u, invalid_offset("ab\xC4"sv));
+		EXPECT_EQ(4u, invalid_offset("ab\xC4\x85\xED\xA0\x80"sv));
+		EXPECT_EQ(0u, invalid_offset("\x80"sv));
+	}
+
+	static std::string large_text() {
+		std::string text;
+		auto const line = "zażółć gęślą jaźń, съешь же ещё 漢字 😀\n"s;
+		while (text.size() < 8 * 1024 * 1024)
+			text += line;
+		return text;
+	}
+
+	TEST(validate, parallel) {
+		auto const text = large_text();
+		EXPECT_EQ(npos, invalid_offset(text, 4));
+		EXPECT_EQ(npos, invalid_offset(text, 0));
+
+		for (auto const fraction : {0.0, 0.25, 0.5, 0.6, 0.75, 0.9999}) {
+			auto broken = text;
+			auto pos = static_cast<std::size_t>(
+			    static_cast<double>(broken.size()) * fraction);
+			broken[pos] = '\xFF';
+			// the error is reported at the start of the broken sequence
+			auto const expected = invalid_offset(broken);
+			EXPECT_LE(expected, pos) << fraction;
+			EXPECT_LE(pos - expected, 3u) << fraction;
+			EXPECT_EQ(expected, invalid_offset(broken, 4)) << fraction;
+			EXPECT_EQ(expected, invalid_offset(broken, 7)) << fraction;
+
+			// a second error later on does not matter
+			broken[broken.size() - 2] = '\xC0';
+			EXPECT_EQ(expected, invalid_offset(broken, 4)) << fraction;
+		}
+	}
+
+	TEST(validate, split_sequences) {
+		auto text = large_text();
+		// a truncated sequence at every possible place of a slice boundary
+		for (std::size_t threads = 2; threads < 6; ++threads) {
+			auto broken = text;
+			auto const split = broken.size() / threads;
+			broken.replace(split - 1, 4, "\xF0\x9F\x98 ");
+			EXPECT_EQ(invalid_offset(broken), invalid_offset(broken, 4))
+			    << threads;
+			EXPECT_EQ(split - 1, invalid_offset(broken, 4)) << threads;
+		}
+	}
+
+	// the first unpaired surrogate, brute force
+	static std::size_t reference_offset(std::u16string_view text) {
+		for (std::size_t pos = 0; pos < text.size(); ++pos) {
+			auto const unit = text[pos];
+			if (unit >= 0xDC00 && unit <= 0xDFFF) return pos;
+			if (unit >= 0xD800 && unit <= 0xDBFF) {
+				if (pos + 1 == text.size()) return pos;
+				auto const next = text[pos + 1];
+				if (next < 0xDC00 || next > 0xDFFF) return pos;
+				++pos;
+			}
+		}
+		return npos;
+	}
+
+	TEST(validate, utf16_offsets) {
+		EXPECT_EQ(npos, invalid_offset(u""sv));
+		EXPECT_EQ(npos, invalid_offset(u"zażółć \U0001F600"sv));
+		EXPECT_EQ(1u, invalid_offset(u"a\xDC00"sv));
+		EXPECT_EQ(1u, invalid_offset(u"a\xD800"sv));
+		EXPECT_EQ(1u, invalid_offset(u"a\xD800z"sv));
+		EXPECT_EQ(3u, invalid_offset(u"a\xD800\xDC00\xDC00"sv));
+		EXPECT_FALSE(is_valid(u"a\xDC00"sv));
+		EXPECT_TRUE(as_str8(u"a\xDC00"sv).empty());
+		EXPECT_TRUE(as_u32(u"a\xDC00"sv).empty());
+	}
+
+	TEST(validate, utf16_blocks) {
+		auto const pair = u"\U0001F600"sv;
+		auto const units = {u'\xD800', u'\xDBFF', u'\xDC00', u'\xDFFF'};
+		// every place relative to the block boundaries of every tier
+		for (std::size_t pos = 0; pos < 40; ++pos) {
+			auto good = std::u16string(40, u'a');
+			good.replace(pos, 0, pair);
+			EXPECT_EQ(npos, invalid_offset(good)) << pos;
+			EXPECT_TRUE(is_valid(good)) << pos;
+
+			for (auto const unit : units) {
+				auto text = std::u16string(40, u'a');
+				text[pos] = unit;
+				EXPECT_EQ(reference_offset(text), invalid_offset(text))
+				    << pos << ' ' << static_cast<unsigned>(unit);
+
+				text = good;
+				text[pos + 1 < text.size() ? pos + 1 : pos] = unit;
+				EXPECT_EQ(reference_offset(text), invalid_offset(text))
+				    << pos << ' ' << static_cast<unsigned>(unit);
+
+				text = good;
+				text.replace(pos, 1, 1, unit);
+				EXPECT_EQ(reference_offset(text), invalid_offset(text))
+				    << pos << ' ' << static_cast<unsigned>(unit);
+			}
+		}
+	}
+}  // namespace utf::testing
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <utf/utf.hpp>
+
+namespace utf::testing {
+	using namespace ::std::literals;
+
+	TEST(variants, wtf8_round_trip) {
+		auto const ill_formed = u"a\xD800" u"b\xDC00\xD800"sv;
+		auto const wtf8 = "a\xED\xA0\x80" "b\xED\xB0\x80\xED\xA0\x80"sv;
+
+		EXPECT_EQ(wtf8, as_str8(ill_formed, utf8_variant::wtf8));
+		EXPECT_EQ(ill_formed, as_u16(wtf8, utf8_variant::wtf8));
+		EXPECT_TRUE(is_valid(wtf8, utf8_variant::wtf8));
+		EXPECT_FALSE(is_valid(wtf8));
+		EXPECT_TRUE(as_str8(ill_formed, utf8_variant::strict).empty());
+
+		auto const utf32 = U"a\xD800" U"b\xDC00\xD800"sv;
+		EXPECT_EQ(utf32, as_u32(wtf8, utf8_variant::wtf8));
+		EXPECT_EQ(wtf8, as_str8(utf32, utf8_variant::wtf8));
+	}
+
+	TEST(variants, wtf8_pairs) {
+		EXPECT_EQ("\xF0\x9F\x98\x80"s,
+		          as_str8(u"\U0001F600"sv, utf8_variant::wtf8));
+		EXPECT_EQ("\xF0\x9F\x98\x80"s,
+		          as_str8(U"\xD83D\xDE00"sv, utf8_variant::wtf8));
+		// a pair must use the four-byte form
+		EXPECT_FALSE(
+		    is_valid("\xED\xA0\xBD\xED\xB8\x80"sv, utf8_variant::wtf8));
+		EXPECT_TRUE(as_u16("\xED\xA0\xBD\xED\xB8\x80"sv, utf8_variant::wtf8)
+		                .empty());
+	}
+
+	TEST(variants, cesu8) {
+		auto const cesu8 = "x\xED\xA0\xBD\xED\xB8\x80y"sv;
+		EXPECT_EQ(cesu8, as_str8(u"x\U0001F600y"sv, utf8_variant::cesu8));
+		EXPECT_EQ(cesu8, as_str8(U"x\U0001F600y"sv, utf8_variant::cesu8));
+		EXPECT_EQ(u"x\U0001F600y"sv, as_u16(cesu8, utf8_variant::cesu8));
+		EXPECT_EQ(U"x\U0001F600y"sv, as_u32(cesu8, utf8_variant::cesu8));
+
+		EXPECT_FALSE(is_valid("\xF0\x9F\x98\x80"sv, utf8_variant::cesu8));
+		EXPECT_FALSE(is_valid("\xED\xA0\xBD"sv, utf8_variant::cesu8));
+		EXPECT_FALSE(is_valid("\xED\xB8\x80"sv, utf8_variant::cesu8));
+		EXPECT_TRUE(as_str8(u"\xD800"sv, utf8_variant::cesu8).empty());
+	}
+
+	TEST(variants, mutf8) {
+		auto const mutf8 = "a\xC0\x80\xED\xA0\xBD\xED\xB8\x80\xED\xA0\x80"sv;
+		auto const java = u"a\0\U0001F600\xD800"sv;
+		EXPECT_EQ(mutf8, as_str8(java, utf8_variant::mutf8));
+		EXPECT_EQ(java, as_u16(mutf8, utf8_variant::mutf8));
+
+		EXPECT_FALSE(is_valid("a\0b"sv, utf8_variant::mutf8));
+		EXPECT_FALSE(is_valid("\xC0\x80"sv));
+		EXPECT_FALSE(is_valid("\xC0"sv, utf8_variant::mutf8));
+	}
+
+	TEST(variants, mutf8_nul_runs) {
+		// NULs ending ASCII runs inside, at and across the scanned blocks
+		for (auto const run : {0u, 1u, 63u, 64u, 65u, 130u}) {
+			std::u16string java;
+			std::string utf8;
+			std::string mutf8;
+			for (int count = 0; count < 3; ++count) {
+				java += std::u16string(run, u'a') + u'\0';
+				utf8 += std::string(run, 'a') + '\0';
+				mutf8 += std::string(run, 'a') + "\xC0\x80";
+			}
+			java += u'b';
+			utf8 += 'b';
+			mutf8 += 'b';
+			EXPECT_EQ(mutf8, as_str8(java, utf8_variant::mutf8)) << run;
+			EXPECT_EQ(mutf8, as_str8(utf8, utf8_variant::strict,
+			                         utf8_variant::mutf8))
+			    << run;
+			EXPECT_EQ(java, as_u16(mutf8, utf8_variant::mutf8)) << run;
+		}
+	}
+
+	TEST(variants, recode) {
+		auto const utf8 = "a\0\xC4\x85\xF0\x9F\x98\x80"sv;
+		auto const mutf8 = "a\xC0\x80\xC4\x85\xED\xA0\xBD\xED\xB8\x80"sv;
+		EXPECT_EQ(mutf8, as_str8(utf8, utf8_variant::strict,
+		                         utf8_variant::mutf8));
+		EXPECT_EQ(utf8, as_str8(mutf8, utf8_variant::mutf8,
+		                        utf8_variant::strict));
+		EXPECT_EQ(utf8, as_str8(utf8, utf8_variant::wtf8,
+		                        utf8_variant::strict));
+		// unpaired surrogates have no place in UTF-8
+		EXPECT_TRUE(as_str8("\xED\xA0\x80"sv, utf8_variant::wtf8,
+		                    utf8_variant::strict)
+		                .empty());
+		EXPECT_EQ("\xED\xA0\x80"s, as_str8("\xED\xA0\x80"sv,
+		                                   utf8_variant::wtf8,
+		                                   utf8_variant::mutf8));
+	}
+
+	TEST(variants, long_ascii_runs) {
+		auto text = std::u16string(70, u'a') + u'\xDBFF' +
+		            std::u16string(33, u'\0') + u'\xDFFF';
+		auto const mutf8 = as_str8(text, utf8_variant::mutf8);
+		EXPECT_EQ(70u + 3 + 33 * 2 + 3, mutf8.size());
+		EXPECT_EQ(text, as_u16(mutf8, utf8_variant::mutf8));
+
+		auto const wtf8 = as_str8(text, utf8_variant::wtf8);
+		EXPECT_EQ(70u + 3 + 33 + 3, wtf8.size());
+		EXPECT_EQ(text, as_u16(wtf8, utf8_variant::wtf8));
+	}
+}  // namespace utf::testing